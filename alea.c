@@ -0,0 +1,32 @@
+#include "alea.h"
+
+/** Générateur splitmix64, utilisé pour remplir l'état à partir de la graine */
+static uint64_t splitmix64(uint64_t * x) {
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+void initAlea(Alea * alea, uint64_t graine) {
+	int i;
+	for (i = 0 ; i < 4 ; i++)
+		alea->s[i] = splitmix64(&graine);
+}
+
+void sautAlea(Alea * alea) {
+	static const uint64_t saut[4] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+	uint64_t s[4] = { 0, 0, 0, 0 };
+	int i, b, j;
+	for (i = 0 ; i < 4 ; i++) {
+		for (b = 0 ; b < 64 ; b++) {
+			if (saut[i] & ((uint64_t)1 << b))
+				for (j = 0 ; j < 4 ; j++)
+					s[j] ^= alea->s[j];
+			alea64(alea);
+		}
+	}
+	for (j = 0 ; j < 4 ; j++)
+		alea->s[j] = s[j];
+}
@@ -0,0 +1,60 @@
+#ifndef ALEA_H_INCLUDED
+#define ALEA_H_INCLUDED
+
+#include <stdint.h>
+
+/**
+    Générateur de nombres pseudo-aléatoires (xoshiro256**).
+    Chaque recherche (et chaque thread) possède son propre générateur :
+    aucun état global n'est partagé entre les threads.
+*/
+
+/** Définition du type Alea (état du générateur) */
+typedef struct {
+
+	uint64_t s[4];
+
+} Alea;
+
+/** Initialise le générateur à partir d'une graine
+    (deux générateurs initialisés avec la même graine produisent la même suite) */
+void initAlea(Alea * alea, uint64_t graine);
+
+/** Avance le générateur de 2^128 tirages :
+    en copiant le générateur avant chaque saut, on obtient des suites indépendantes (une par thread) */
+void sautAlea(Alea * alea);
+
+/** Retourne un entier aléatoire sur 64 bits */
+static inline uint64_t alea64(Alea * alea) {
+	uint64_t * s = alea->s;
+	uint64_t x = s[1] * 5;
+	uint64_t resultat = ((x << 7) | (x >> 57)) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+
+	return resultat;
+}
+
+/** Retourne un entier aléatoire uniforme (sans biais) dans [0, n[ (n > 0)
+    (méthode de Lemire : multiplication puis rejet des rares tirages biaisés) */
+static inline uint32_t aleaBorne(Alea * alea, uint32_t n) {
+	uint64_t m = (alea64(alea) >> 32) * n;
+	uint32_t reste = (uint32_t)m;
+
+	if (reste < n) {
+		uint32_t seuil = -n % n;
+		while (reste < seuil) {
+			m = (alea64(alea) >> 32) * n;
+			reste = (uint32_t)m;
+		}
+	}
+	return (uint32_t)(m >> 32);
+}
+
+#endif // ALEA_H_INCLUDED
@@ -0,0 +1,61 @@
+#include "arene.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+Arene * nouvelleArene(size_t tailleElement) {
+	Arene * arene = (Arene *)malloc(sizeof(Arene));
+
+	arene->tailleElement = tailleElement;
+	arene->nb_elements = 0;
+	arene->nb_blocs = 0;
+	pthread_mutex_init(&arene->verrou, NULL);
+
+	int i;
+	for (i = 0 ; i < ARENE_NB_BLOCS_MAX ; i++)
+		arene->blocs[i] = NULL;
+
+	return arene;
+}
+
+uint32_t allouerElement(Arene * arene) {
+	// chaque thread obtient un indice différent
+	uint32_t indice = __atomic_fetch_add(&arene->nb_elements, 1, __ATOMIC_RELAXED);
+	uint32_t bloc = indice >> ARENE_BITS_BLOC;
+
+	if (bloc >= ARENE_NB_BLOCS_MAX) {
+		fprintf(stderr, "Arène pleine : impossible d'allouer plus de %u éléments.\n", ARENE_NB_BLOCS_MAX * ARENE_TAILLE_BLOC);
+		exit(EXIT_FAILURE);
+	}
+	// Si l'élément se trouve dans un bloc pas encore alloué
+	if (__atomic_load_n(&arene->blocs[bloc], __ATOMIC_ACQUIRE) == NULL) {
+		pthread_mutex_lock(&arene->verrou);
+		// le bloc a pu être alloué par un autre thread entre-temps
+		if (arene->blocs[bloc] == NULL) {
+			char * nouveauBloc = (char *)malloc(ARENE_TAILLE_BLOC * arene->tailleElement);
+			if (nouveauBloc == NULL) {
+				fprintf(stderr, "Mémoire insuffisante pour allouer un nouveau bloc de l'arène.\n");
+				exit(EXIT_FAILURE);
+			}
+			__atomic_store_n(&arene->blocs[bloc], nouveauBloc, __ATOMIC_RELEASE);
+			arene->nb_blocs++;
+		}
+		pthread_mutex_unlock(&arene->verrou);
+	}
+
+	return indice;
+}
+
+void viderArene(Arene * arene) {
+	arene->nb_elements = 0;
+}
+
+void freeArene(Arene * arene) {
+	int i;
+	for (i = 0 ; i < ARENE_NB_BLOCS_MAX ; i++)
+		if (arene->blocs[i] != NULL)
+			free(arene->blocs[i]);
+
+	pthread_mutex_destroy(&arene->verrou);
+	free(arene);
+}
@@ -0,0 +1,57 @@
+#ifndef ARENE_H_INCLUDED
+#define ARENE_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+/**
+    Allocateur par blocs (arène) : les éléments, tous de même taille, sont alloués
+    les uns à la suite des autres dans des blocs et désignés par un indice sur 32 bits.
+    Les éléments ne sont jamais libérés individuellement : l'arène est vidée d'un coup.
+*/
+
+// Paramètres de l'arène
+#define ARENE_BITS_BLOC 16                          // log2 du nb d'éléments par bloc
+#define ARENE_TAILLE_BLOC (1u << ARENE_BITS_BLOC)   // nb d'éléments par bloc
+#define ARENE_NB_BLOCS_MAX 4096                     // nb max de blocs (soit 2^28 éléments)
+
+/** Indice d'un élément qui n'existe pas */
+#define ARENE_AUCUN UINT32_MAX
+
+/** Définition du type Arene */
+typedef struct {
+
+	size_t tailleElement;   // taille d'un élément (en octets)
+	uint32_t nb_elements;   // nb d'éléments alloués (le prochain élément alloué aura cet indice)
+
+	char * blocs[ARENE_NB_BLOCS_MAX];   // blocs alloués (NULL si pas encore utilisés)
+	int nb_blocs;                       // nb de blocs alloués
+
+	pthread_mutex_t verrou; // protège l'allocation des blocs lorsque plusieurs threads allouent en même temps
+
+} Arene;
+
+/** Créer une nouvelle arène (vide) d'éléments de la taille donnée */
+Arene * nouvelleArene(size_t tailleElement);
+
+/** Alloue un élément (non initialisé) et retourne son indice
+    (les blocs sont alloués au fur et à mesure des besoins)
+    Peut être appelée par plusieurs threads en même temps. */
+uint32_t allouerElement(Arene * arene);
+
+/** Retourne l'adresse de l'élément d'indice donné
+    (l'adresse reste valide tant que l'arène n'est pas vidée) */
+static inline void * elementArene(Arene * arene, uint32_t indice) {
+	return arene->blocs[indice >> ARENE_BITS_BLOC] + (size_t)(indice & (ARENE_TAILLE_BLOC - 1)) * arene->tailleElement;
+}
+
+/** Libère tous les éléments de l'arène en temps constant
+    (les blocs sont conservés pour être réutilisés)
+    Aucun autre thread ne doit utiliser l'arène pendant l'appel. */
+void viderArene(Arene * arene);
+
+/** Libère la mémoire de l'arène et de tous ses blocs */
+void freeArene(Arene * arene);
+
+#endif // ARENE_H_INCLUDED
@@ -0,0 +1,318 @@
+#include "puissance4.h"
+#include "mcts.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+
+/**
+    Microbenchmarks des fonctions du jeu et des phases de MCTS, sur un corpus fixe de positions
+    et avec une graine fixe : les résultats de deux versions du code peuvent être comparés directement.
+    Chaque mesure est répétée et la médiane est affichée, à raison d'une ligne par mesure :
+    nom <tab> ns par appel <tab> appels par seconde
+    A compiler avec :
+    gcc -O2 -o Bench bench.c puissance4.c mcts.c arene.c alea.c transposition.c chrono.c livre.c finale.c -lm -lpthread utils.c
+*/
+
+// Graine fixe des mesures
+#define GRAINE_BENCH 20240101
+
+// Nb de répétitions de chaque mesure (la médiane est retenue)
+#define NB_REPETITIONS 5
+
+// Nb de positions du corpus
+#define NB_POSITIONS 16
+
+/** Corpus de positions : coups joués depuis le début de la partie (l'humain commence),
+    de 0 à 30 pions, aucune n'étant terminale
+    (valable pour toutes les variantes d'au moins 6 lignes, 7 colonnes et 4 pions à aligner) */
+static const char * corpus[NB_POSITIONS] = {
+    "", "31", "5421", "536562", "41565323", "4541245240", "141630625330", "55162322612332",
+    "4163110516062642", "646534026546113211", "23465123422553615566", "6446450404146200201016",
+    "451112316123500250615460", "53062102464114403045523411", "6631153620300421536465016411",
+    "452001645531611060200322253121"
+};
+
+/** Données communes aux mesures */
+typedef struct {
+
+	Etat positions[NB_POSITIONS];
+	Coup coups[NB_POSITIONS];       // un coup possible de chaque position
+	Alea alea;
+
+	// arbre de recherche pour les mesures de la sélection et de la propagation
+	Arene * arene;
+	IndiceNoeud racine;
+	Etat etatRacine;
+	Chemin chemin;
+
+	volatile long long puits;       // empêche le compilateur de supprimer les appels mesurés
+
+} ContexteBench;
+
+/** Une mesure : réalise n appels de la fonction mesurée */
+typedef void (*FonctionBench)(ContexteBench * contexte, long n);
+
+static void benchTestFin(ContexteBench * contexte, long n) {
+    long long somme = 0;
+    long k;
+    for (k = 0 ; k < n ; k++)
+        somme += testFin(&contexte->positions[k % NB_POSITIONS]);
+    contexte->puits += somme;
+}
+
+static void benchJouerCoup(ContexteBench * contexte, long n) {
+    // (la copie de la position sur laquelle le coup est joué est comprise dans la mesure)
+    long long somme = 0;
+    long k;
+    for (k = 0 ; k < n ; k++) {
+        Etat etat = contexte->positions[k % NB_POSITIONS];
+        somme += jouerCoup(&etat, &contexte->coups[k % NB_POSITIONS]) + etat.masque;
+    }
+    contexte->puits += somme;
+}
+
+static void benchCoupsPossibles(ContexteBench * contexte, long n) {
+    // (la libération de la liste de coups est comprise dans la mesure)
+    long long somme = 0;
+    long k;
+    for (k = 0 ; k < n ; k++) {
+        Coup ** coups = coups_possibles(&contexte->positions[k % NB_POSITIONS]);
+        int i;
+        for (i = 0 ; coups[i] != NULL ; i++) {
+            somme += coups[i]->colonne;
+            free(coups[i]);
+        }
+        free(coups);
+    }
+    contexte->puits += somme;
+}
+
+static void benchMasqueCoupsPossibles(ContexteBench * contexte, long n) {
+    long long somme = 0;
+    long k;
+    for (k = 0 ; k < n ; k++)
+        somme += masque_coups_possibles(&contexte->positions[k % NB_POSITIONS]);
+    contexte->puits += somme;
+}
+
+static void benchCopieEtat(ContexteBench * contexte, long n) {
+    // (la libération de la copie est comprise dans la mesure)
+    long long somme = 0;
+    long k;
+    for (k = 0 ; k < n ; k++) {
+        Etat * copie = copieEtat(&contexte->positions[k % NB_POSITIONS]);
+        somme += copie->nb_coups;
+        free(copie);
+    }
+    contexte->puits += somme;
+}
+
+static void benchSimulerPartieAleatoire(ContexteBench * contexte, long n) {
+    long long somme = 0;
+    long k;
+    for (k = 0 ; k < n ; k++)
+        somme += simulerPartie(&contexte->positions[k % NB_POSITIONS], ALEATOIRE, &contexte->alea);
+    contexte->puits += somme;
+}
+
+static void benchSimulerPartieCoupGagnant(ContexteBench * contexte, long n) {
+    long long somme = 0;
+    long k;
+    for (k = 0 ; k < n ; k++)
+        somme += simulerPartie(&contexte->positions[k % NB_POSITIONS], COUP_GAGNANT, &contexte->alea);
+    contexte->puits += somme;
+}
+
+static void benchSimulerPartieMenaces(ContexteBench * contexte, long n) {
+    long long somme = 0;
+    long k;
+    for (k = 0 ; k < n ; k++)
+        somme += simulerPartie(&contexte->positions[k % NB_POSITIONS], MENACES, &contexte->alea);
+    contexte->puits += somme;
+}
+
+static void benchSimulerLot(ContexteBench * contexte, long n, PolitiqueSimulation politique) {
+    // (n simulations par lots de LOT_SIMULATIONS parties : la mesure est rapportée à une simulation)
+    ResultatsSimulations resultats = { 0, 0, 0, 0 };
+    long k;
+    for (k = 0 ; k < n ; k += LOT_SIMULATIONS)
+        simulerParties(&contexte->positions[(k / LOT_SIMULATIONS) % NB_POSITIONS], LOT_SIMULATIONS, politique, &contexte->alea, &resultats);
+    contexte->puits += resultats.nb_victoires + resultats.nb_coups;
+}
+
+static void benchSimulerLotAleatoire(ContexteBench * contexte, long n) {
+    benchSimulerLot(contexte, n, ALEATOIRE);
+}
+
+static void benchSimulerLotCoupGagnant(ContexteBench * contexte, long n) {
+    benchSimulerLot(contexte, n, COUP_GAGNANT);
+}
+
+static void benchSimulerLotMenaces(ContexteBench * contexte, long n) {
+    benchSimulerLot(contexte, n, MENACES);
+}
+
+static void benchSelectionUCB(ContexteBench * contexte, long n) {
+    // (l'arbre n'étant pas modifié, le même chemin est parcouru à chaque appel)
+    long long somme = 0;
+    long k;
+    for (k = 0 ; k < n ; k++)
+        somme += selectionUCB(contexte->arene, contexte->racine, &contexte->etatRacine, &contexte->chemin);
+    contexte->puits += somme;
+}
+
+static void benchPropagerResultat(ContexteBench * contexte, long n) {
+    // (propagation le long du dernier chemin sélectionné, le résultat alternant entre victoire et défaite)
+    long k;
+    for (k = 0 ; k < n ; k++)
+        propagerResultat(contexte->arene, &contexte->chemin, k % 2 == 0 ? ORDI_GAGNE : HUMAIN_GAGNE);
+}
+
+/** Retourne le temps (en secondes) mis pour n appels de la fonction mesurée */
+static double mesurer(FonctionBench fonction, ContexteBench * contexte, long n) {
+    struct timespec debut, fin;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    fonction(contexte, n);
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+static int comparerDoubles(const void * a, const void * b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/** Mesure une fonction et affiche la médiane des temps par appel
+    (le nb d'appels est doublé jusqu'à ce qu'une mesure dure au moins duree secondes) */
+static void lancerBench(char * nom, FonctionBench fonction, ContexteBench * contexte, double duree) {
+    long n = 1;
+    while (mesurer(fonction, contexte, n) < duree)
+        n *= 2;
+
+    double nsParAppel[NB_REPETITIONS];
+    int r;
+    for (r = 0 ; r < NB_REPETITIONS ; r++)
+        nsParAppel[r] = mesurer(fonction, contexte, n) * 1e9 / n;
+    qsort(nsParAppel, NB_REPETITIONS, sizeof(double), comparerDoubles);
+
+    double mediane = nsParAppel[NB_REPETITIONS / 2];
+    printf("%s\t%0.2f\t%0.0f\n", nom, mediane, 1e9 / mediane);
+    fflush(stdout);
+}
+
+/** Construit dans l'arène du contexte un arbre d'au moins nbNoeuds noeuds à partir de la position initiale
+    (itérations MCTS complètes, avec la table de transposition) */
+static void construireArbre(ContexteBench * contexte, uint32_t nbNoeuds) {
+    TableTransposition * table = nouvelleTable();
+    viderArene(contexte->arene);
+
+    contexte->etatRacine = contexte->positions[0];
+    contexte->racine = nouveauNoeud(contexte->arene, &contexte->etatRacine);
+    ajouterPosition(table, clePosition(&contexte->etatRacine), contexte->racine);
+
+    while (contexte->arene->nb_elements < nbNoeuds) {
+        selectionUCB(contexte->arene, contexte->racine, &contexte->etatRacine, &contexte->chemin);
+        expansionNoeud(contexte->arene, table, &contexte->chemin, &contexte->alea);
+        propagerResultat(contexte->arene, &contexte->chemin, simulerPartie(&contexte->chemin.etat, COUP_GAGNANT, &contexte->alea));
+    }
+    freeTable(table);
+}
+
+int main(int argc, char **argv) {
+
+    double duree = 0.05;    // durée minimale d'une mesure (en secondes)
+    char * filtre = NULL;   // seules les mesures dont le nom contient le filtre sont réalisées
+
+    int opt;
+    while ( (opt = getopt(argc, argv, "hd:f:")) != -1 ) {
+        double doubleResult = 0;
+        switch (opt) {
+            case 'd' :
+                if (convertStringToDouble(optarg, &doubleResult) && doubleResult > 0)
+                    duree = doubleResult;
+                else {
+                    fprintf(stderr, "L'option -d requiert un nombre décimal positif non nul en argument.\n");
+                    return 1;
+                }
+                break;
+            case 'f' :
+                filtre = optarg;
+                break;
+            default :
+                printf("utilisation : Bench [-d durée minimale d'une mesure en secondes (0.05 par défaut)] [-f filtre sur le nom des mesures]\n");
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    ContexteBench * contexte = (ContexteBench *)malloc(sizeof(ContexteBench));
+    initAlea(&contexte->alea, GRAINE_BENCH);
+    contexte->puits = 0;
+
+    // Positions du corpus
+    int i;
+    for (i = 0 ; i < NB_POSITIONS ; i++) {
+        Etat * etat = etat_initial();
+        const char * c;
+        for (c = corpus[i] ; *c != '\0' ; c++) {
+            Coup coup = { *c - '0' };
+            if (!jouerCoup(etat, &coup) || testFin(etat) != NON) {
+                fprintf(stderr, "Position %d du corpus incorrecte.\n", i);
+                return 1;
+            }
+        }
+        contexte->positions[i] = *etat;
+        contexte->coups[i].colonne = __builtin_ctz(masque_coups_possibles(etat));
+        free(etat);
+    }
+
+    struct {
+        char * nom;
+        FonctionBench fonction;
+    } mesures[] = {
+        { "testFin", benchTestFin },
+        { "jouerCoup", benchJouerCoup },
+        { "coups_possibles", benchCoupsPossibles },
+        { "masque_coups_possibles", benchMasqueCoupsPossibles },
+        { "copieEtat", benchCopieEtat },
+        { "simulerPartie/aleatoire", benchSimulerPartieAleatoire },
+        { "simulerPartie/coup_gagnant", benchSimulerPartieCoupGagnant },
+        { "simulerPartie/menaces", benchSimulerPartieMenaces },
+        { "simulerParties/lot_aleatoire", benchSimulerLotAleatoire },
+        { "simulerParties/lot_coup_gagnant", benchSimulerLotCoupGagnant },
+        { "simulerParties/lot_menaces", benchSimulerLotMenaces },
+    };
+
+    printf("# mesure\tns/appel\tappels/s\n");
+    for (i = 0 ; i < (int)(sizeof(mesures) / sizeof(mesures[0])) ; i++)
+        if (filtre == NULL || strstr(mesures[i].nom, filtre) != NULL)
+            lancerBench(mesures[i].nom, mesures[i].fonction, contexte, duree);
+
+    // Sélection et propagation sur des arbres de différentes tailles
+    uint32_t taillesArbres[] = { 1000, 100000, 1000000 };
+    contexte->arene = nouvelleArene(sizeof(Noeud));
+    for (i = 0 ; i < (int)(sizeof(taillesArbres) / sizeof(taillesArbres[0])) ; i++) {
+        char nomSelection[64], nomPropagation[64];
+        snprintf(nomSelection, sizeof(nomSelection), "selectionUCB/%u", taillesArbres[i]);
+        snprintf(nomPropagation, sizeof(nomPropagation), "propagerResultat/%u", taillesArbres[i]);
+        bool selection = filtre == NULL || strstr(nomSelection, filtre) != NULL;
+        bool propagation = filtre == NULL || strstr(nomPropagation, filtre) != NULL;
+        if (!selection && !propagation)
+            continue;
+
+        construireArbre(contexte, taillesArbres[i]);
+        if (selection)
+            lancerBench(nomSelection, benchSelectionUCB, contexte, duree);
+        if (propagation) {
+            selectionUCB(contexte->arene, contexte->racine, &contexte->etatRacine, &contexte->chemin);
+            lancerBench(nomPropagation, benchPropagerResultat, contexte, duree);
+        }
+    }
+    freeArene(contexte->arene);
+    free(contexte);
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "chrono.h"
+
+void demarrerBudget(BudgetTemps * budget, double tempsmax, int * annulation) {
+	clock_gettime(CLOCK_MONOTONIC, &budget->debut);
+	budget->tempsmax = tempsmax;
+	budget->annulation = annulation;
+	budget->arret = 0;
+}
+
+double tempsEcoule(BudgetTemps * budget) {
+	struct timespec maintenant;
+	clock_gettime(CLOCK_MONOTONIC, &maintenant);
+	return (maintenant.tv_sec - budget->debut.tv_sec) + (maintenant.tv_nsec - budget->debut.tv_nsec) / 1e9;
+}
+
+void initControle(ControleTemps * controle, BudgetTemps * budget) {
+	controle->budget = budget;
+	controle->intervalle = 1;   // la première consultation mesure la durée d'une itération
+	controle->restant = 1;
+	controle->derniereMesure = 0;
+}
+
+bool verifierBudget(ControleTemps * controle) {
+	BudgetTemps * budget = controle->budget;
+
+	// Arrêt décidé par un autre thread ou annulation externe
+	if (__atomic_load_n(&budget->arret, __ATOMIC_RELAXED)
+	    || (budget->annulation != NULL && __atomic_load_n(budget->annulation, __ATOMIC_RELAXED))) {
+		__atomic_store_n(&budget->arret, 1, __ATOMIC_RELAXED);
+		return true;
+	}
+
+	double maintenant = tempsEcoule(budget);
+	if (budget->tempsmax > 0 && maintenant >= budget->tempsmax) {
+		__atomic_store_n(&budget->arret, 1, __ATOMIC_RELAXED);
+		return true;
+	}
+
+	// On adapte l'intervalle à la vitesse mesurée depuis la dernière consultation
+	// (sans dépasser la moitié du temps restant)
+	double periode = CHRONO_PERIODE;
+	if (budget->tempsmax > 0 && (budget->tempsmax - maintenant) / 2 < periode)
+		periode = (budget->tempsmax - maintenant) / 2;
+
+	double duree = maintenant - controle->derniereMesure;
+	double intervalle = duree > 0 ? controle->intervalle * periode / duree : CHRONO_INTERVALLE_MAX;
+	if (intervalle < 1)
+		intervalle = 1;
+	if (intervalle > CHRONO_INTERVALLE_MAX)
+		intervalle = CHRONO_INTERVALLE_MAX;
+
+	controle->intervalle = (int)intervalle;
+	controle->restant = controle->intervalle;
+	controle->derniereMesure = maintenant;
+	return false;
+}
@@ -0,0 +1,75 @@
+#ifndef CHRONO_H_INCLUDED
+#define CHRONO_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+    Contrôle du temps de recherche : le temps est mesuré sur l'horloge monotone (temps réel),
+    et l'horloge n'est consultée que toutes les N itérations, N étant adapté à la vitesse mesurée
+    de façon à vérifier le temps environ toutes les CHRONO_PERIODE secondes.
+    La recherche peut aussi être annulée de l'extérieur par un drapeau.
+*/
+
+// Paramètres du contrôle
+#define CHRONO_PERIODE 0.001            // intervalle visé entre deux consultations de l'horloge (en secondes)
+#define CHRONO_INTERVALLE_MAX (1 << 16) // nb maximal d'itérations entre deux consultations
+
+/** Budget de temps d'une recherche (commun à tous les threads) */
+typedef struct {
+
+	struct timespec debut;  // début de la recherche
+	double tempsmax;        // temps maximal (pas de limite si nul ou négatif)
+	int * annulation;       // drapeau d'annulation externe (NULL si aucun) : la recherche s'arrête s'il est non nul
+	int arret;              // mis à 1 par le premier thread qui constate la fin du budget
+
+} BudgetTemps;
+
+/** Contrôle du budget propre à un thread */
+typedef struct {
+
+	BudgetTemps * budget;
+	int intervalle;         // nb d'itérations entre deux consultations de l'horloge
+	int restant;            // nb d'itérations avant la prochaine consultation
+	double derniereMesure;  // temps écoulé lors de la dernière consultation
+
+} ControleTemps;
+
+/** Démarre le budget de temps (maintenant) */
+void demarrerBudget(BudgetTemps * budget, double tempsmax, int * annulation);
+
+/** Retourne le temps (en secondes) écoulé depuis le début du budget */
+double tempsEcoule(BudgetTemps * budget);
+
+/** Initialise le contrôle du budget d'un thread */
+void initControle(ControleTemps * controle, BudgetTemps * budget);
+
+/** Consulte l'horloge et le drapeau d'annulation, adapte l'intervalle
+    et retourne vrai si la recherche doit s'arrêter */
+bool verifierBudget(ControleTemps * controle);
+
+/** Retourne vrai si la recherche doit s'arrêter (à appeler à chaque itération :
+    ne consulte l'horloge que lorsque l'intervalle est écoulé) */
+static inline bool budgetEpuise(ControleTemps * controle) {
+	if (--controle->restant > 0)
+		return false;
+	return verifierBudget(controle);
+}
+
+/** Retourne un compteur de cycles du processeur (pour mesurer la durée de portions de code très courtes)
+    (à défaut de compteur de cycles, le temps en nanosecondes de l'horloge monotone) */
+static inline uint64_t compteurCycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec maintenant;
+	clock_gettime(CLOCK_MONOTONIC, &maintenant);
+	return (uint64_t)maintenant.tv_sec * 1000000000ULL + maintenant.tv_nsec;
+#endif
+}
+
+#endif // CHRONO_H_INCLUDED
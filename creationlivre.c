@@ -0,0 +1,302 @@
+#include "puissance4.h"
+#include "mcts.h"
+#include "livre.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <getopt.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/**
+    Création d'un livre d'ouvertures (voir livre.h) : une longue recherche MCTS est réalisée
+    sur chaque position où l'ordinateur doit jouer, atteinte en au plus profondeur coups
+    (quel que soit le joueur qui a commencé, une position et sa symétrique n'étant cherchées qu'une fois),
+    et les statistiques des coups de chaque recherche sont écrites dans le livre.
+    A compiler avec :
+    gcc -O2 -o CreationLivre creationlivre.c puissance4.c mcts.c arene.c alea.c transposition.c chrono.c livre.c finale.c -lm -lpthread utils.c
+*/
+
+// Valeurs par défaut
+#define PROFONDEUR_DEFAUT 4
+#define ITERATIONS_DEFAUT 1000000
+#define GRAINE_DEFAUT 1
+#define FICHIER_DEFAUT "livre.bin"
+
+/** Positions à chercher (partagées entre les threads qui réalisent les recherches) */
+typedef struct {
+
+	Etat * positions;
+	int nb_positions;
+	int capacite;
+
+	ParametresMCTS parametres;      // paramètres de chaque recherche
+	uint64_t graine;                // la graine de la recherche d'une position ne dépend que de son numéro
+	int verboseLevel;
+
+	int prochainePosition;          // numéro de la prochaine position à chercher
+	int nb_cherchees;               // nb de recherches terminées (protégé par le verrou)
+	pthread_mutex_t verrou;
+
+	uint32_t (*nb_simus)[LARGEUR_MAX];      // statistiques des coups de chaque position
+	uint32_t (*nb_victoires)[LARGEUR_MAX];
+
+} Creation;
+
+/** Ajoute aux positions à chercher celles atteintes en au plus profondeur coups à partir de l'état
+    (la table contient les clés des positions déjà rencontrées) */
+static void enumererPositions(Creation * creation, TableTransposition * table, Etat * etat, int profondeur) {
+    bool symetrique;
+    uint64_t cle = cleLivre(etat, &symetrique);
+    if (chercherPosition(table, cle) != TABLE_AUCUN)
+        return;
+    ajouterPosition(table, cle, 0);
+
+    if (testFin(etat) != NON)
+        return;
+
+    if (etat->joueur == 1) {
+        if (creation->nb_positions == creation->capacite) {
+            creation->capacite *= 2;
+            creation->positions = (Etat *)realloc(creation->positions, creation->capacite * sizeof(Etat));
+            if (creation->positions == NULL) {
+                fprintf(stderr, "Mémoire insuffisante pour énumérer les positions du livre.\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        creation->positions[creation->nb_positions++] = *etat;
+    }
+
+    if (etat->nb_coups >= profondeur)
+        return;
+
+    unsigned int coups = masque_coups_possibles(etat);
+    while (coups != 0) {
+        Coup coup = { __builtin_ctz(coups) };
+        coups &= coups - 1;
+        Etat etatEnfant = *etat;
+        jouerCoup(&etatEnfant, &coup);
+        enumererPositions(creation, table, &etatEnfant, profondeur);
+    }
+}
+
+/** Boucle d'un thread : cherche des positions jusqu'à ce que toutes aient été cherchées */
+static void * threadCreation(void * arg) {
+    Creation * creation = (Creation *)arg;
+    int i, c;
+
+    while ( (i = __atomic_fetch_add(&creation->prochainePosition, 1, __ATOMIC_RELAXED)) < creation->nb_positions ) {
+        // chaque recherche part d'un moteur neuf : le livre ne dépend pas de la répartition des positions
+        MoteurMCTS * moteur = nouveauMoteur();
+        Alea alea;
+        initAlea(&alea, creation->graine + (uint64_t)i);
+        ParametresMCTS parametres = creation->parametres;
+        parametres.alea = &alea;
+
+        Etat etat = creation->positions[i];
+        jouerCoupMCTS(moteur, &etat, &parametres);
+        for (c = 0 ; c < LARGEUR_MAX ; c++) {
+            creation->nb_simus[i][c] = moteur->simus_coups[c];
+            creation->nb_victoires[i][c] = moteur->victoires_coups[c];
+        }
+        freeMoteur(moteur);
+
+        pthread_mutex_lock(&creation->verrou);
+        creation->nb_cherchees++;
+        if (creation->verboseLevel >= 1)
+            printf("Position %d/%d cherchée\n", creation->nb_cherchees, creation->nb_positions);
+        pthread_mutex_unlock(&creation->verrou);
+    }
+
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+
+    Creation creation;
+    ParametresMCTS parametres = { -1, ITERATIONS_DEFAUT, ROBUSTE, 1, 1, RACINE, 1, -1, 0, NULL, NULL, 0, NULL, NULL };
+    int profondeur = PROFONDEUR_DEFAUT;
+    char * fichier = FICHIER_DEFAUT;
+    bool printHelp = false, timeFlag = false, iterationsFlag = false;
+
+    creation.graine = GRAINE_DEFAUT;
+    creation.verboseLevel = 1;
+    int nbThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nbThreads < 1)
+        nbThreads = 1;
+
+    static struct option long_options[] = {
+        {"help", no_argument, 0, 'h'},
+        {"profondeur", required_argument, 0, 'd'},
+        {"depth", required_argument, 0, 'd'},
+        {"temps", required_argument, 0, 't'},
+        {"time", required_argument, 0, 't'},
+        {"iterations", required_argument, 0, 'i'},
+        {"optimisation", required_argument, 0, 'o'},
+        {"optimization", required_argument, 0, 'o'},
+        {"threads", required_argument, 0, 'p'},
+        {"jobs", required_argument, 0, 'j'},
+        {"graine", required_argument, 0, 'g'},
+        {"seed", required_argument, 0, 'g'},
+        {"livre", required_argument, 0, 'b'},
+        {"book", required_argument, 0, 'b'},
+        {"verbose", required_argument, 0, 'v'},
+        {0, 0, 0, 0}
+    };
+
+    int option_index = 0;
+    opterr = 0;
+    int opt = 0;
+
+    while ( (opt = getopt_long (argc, argv, "hd:t:i:o:p:j:g:b:v:", long_options, &option_index)) != -1) {
+        int intResult = 0;
+        double doubleResult = 0;
+        bool correct = true;
+
+        switch (opt) {
+            case 'h' :
+                printHelp = true;
+                break;
+            case 'd' :
+                correct = convertStringToInt(optarg, &intResult) && intResult >= 0 && intResult < NB_CASES;
+                profondeur = intResult;
+                break;
+            case 't' :
+                correct = convertStringToDouble(optarg, &doubleResult) && doubleResult > 0;
+                parametres.tempsmax = doubleResult;
+                timeFlag = true;
+                break;
+            case 'i' :
+                correct = convertStringToInt(optarg, &intResult) && intResult > 0;
+                parametres.iterationsmax = intResult;
+                iterationsFlag = true;
+                break;
+            case 'o' :
+                correct = convertStringToInt(optarg, &intResult) && intResult >= 0;
+                parametres.optimisationLevel = intResult;
+                break;
+            case 'p' :
+                correct = convertStringToInt(optarg, &intResult) && intResult > 0 && intResult <= NB_THREADS_MAX;
+                parametres.nbThreads = intResult;
+                break;
+            case 'j' :
+                correct = convertStringToInt(optarg, &intResult) && intResult > 0;
+                nbThreads = intResult;
+                break;
+            case 'g' :
+                correct = convertStringToUInt64(optarg, &creation.graine);
+                break;
+            case 'b' :
+                fichier = optarg;
+                break;
+            case 'v' :
+                correct = convertStringToInt(optarg, &intResult) && intResult >= 0;
+                creation.verboseLevel = intResult;
+                break;
+            case '?':
+                if (optopt == 'd' || optopt == 't' || optopt == 'i' || optopt == 'o' || optopt == 'p'
+                    || optopt == 'j' || optopt == 'g' || optopt == 'b' || optopt == 'v')
+                    fprintf(stderr, "Argument requis pour l'option -%c.\n", optopt);
+                else if(isprint(optopt))
+                    fprintf (stderr, "Option inconnu : `-%c'.\n", optopt);
+                else
+                    fprintf (stderr, "Option inconnu : `\\x%x'.\n", optopt);
+
+                fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                return 1;
+        }
+
+        if (!correct) {
+            fprintf(stderr, "Argument incorrect pour l'option -%c : %s.\n", opt, optarg);
+            fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+            return 1;
+        }
+    }
+
+    if (printHelp) {
+        printf( "\nutilisation : CreationLivre [options]"
+                "\n\noptions :"
+                "\n\n-d arg (ou --profondeur ou --depth) : nb maximal de coups joués dans les positions du livre (%d par défaut)."
+                "\n\n-t arg (ou --temps ou --time) : temps de la recherche de chaque position (en secondes)."
+                "\n\n-i arg (ou --iterations) : nb d'itérations de la recherche de chaque position (%d par défaut si le temps n'est pas précisé)."
+                "\n\n-o arg (ou --optimisation ou --optimization) : niveau d'optimisation des recherches (1 par défaut)."
+                "\n\n-p arg (ou --threads) : nb de threads de chaque recherche (1 par défaut)."
+                "\n\n-j arg (ou --jobs) : nb de recherches réalisées en parallèle (nombre de processeurs par défaut)."
+                "\n\n-g arg (ou --graine ou --seed) : graine des générateurs aléatoires (%d par défaut)."
+                "\nLa graine de chaque recherche ne dépend que de la position : avec une limite en nombre d'itérations, le livre est reproductible."
+                "\n\n-b arg (ou --livre ou --book) : fichier du livre créé (%s par défaut)."
+                "\n\n-v arg (ou --verbose) : 0 pour n'afficher que le résumé, 1 (par défaut) pour afficher l'avancement."
+                "\n\n", PROFONDEUR_DEFAUT, ITERATIONS_DEFAUT, GRAINE_DEFAUT, FICHIER_DEFAUT);
+        return 0;
+    }
+
+    // Si le temps est précisé et que le nombre d'itérations ne l'est pas
+    if (timeFlag && !iterationsFlag)
+        parametres.iterationsmax = -1;
+    creation.parametres = parametres;
+
+    // Positions du livre, quel que soit le joueur qui commence
+    creation.capacite = 1024;
+    creation.nb_positions = 0;
+    creation.positions = (Etat *)malloc(creation.capacite * sizeof(Etat));
+    TableTransposition * table = nouvelleTable();
+    int joueur;
+    for (joueur = 0 ; joueur < 2 ; joueur++) {
+        Etat * etat = etat_initial();
+        etat->joueur = joueur;
+        enumererPositions(&creation, table, etat, profondeur);
+        free(etat);
+    }
+    freeTable(table);
+    printf("%d positions à chercher (profondeur %d)\n", creation.nb_positions, profondeur);
+
+    creation.nb_simus = malloc(creation.nb_positions * sizeof(*creation.nb_simus));
+    creation.nb_victoires = malloc(creation.nb_positions * sizeof(*creation.nb_victoires));
+    creation.prochainePosition = 0;
+    creation.nb_cherchees = 0;
+    pthread_mutex_init(&creation.verrou, NULL);
+
+    if (nbThreads > creation.nb_positions)
+        nbThreads = creation.nb_positions > 0 ? creation.nb_positions : 1;
+
+    // Le thread principal réalise aussi des recherches
+    pthread_t * threads = (pthread_t *)malloc(nbThreads * sizeof(pthread_t));
+    int t;
+    for (t = 1 ; t < nbThreads ; t++) {
+        if (pthread_create(&threads[t], NULL, threadCreation, &creation) != 0) {
+            fprintf(stderr, "Impossible de créer un thread pour la création du livre.\n");
+            return 1;
+        }
+    }
+    threadCreation(&creation);
+    for (t = 1 ; t < nbThreads ; t++)
+        pthread_join(threads[t], NULL);
+    free(threads);
+    pthread_mutex_destroy(&creation.verrou);
+
+    // Les positions sans statistiques (coup gagnant joué directement au niveau d'optimisation 2) ne sont pas retenues
+    LivreOuvertures * livre = nouveauLivre(creation.nb_positions, profondeur);
+    int i, c;
+    for (i = 0 ; i < creation.nb_positions ; i++) {
+        uint32_t total = 0;
+        for (c = 0 ; c < LARGEUR_MAX ; c++)
+            total += creation.nb_simus[i][c];
+        if (total > 0)
+            ajouterLivre(livre, &creation.positions[i], creation.nb_simus[i], creation.nb_victoires[i]);
+    }
+
+    if (!ecrireLivre(livre, fichier)) {
+        fprintf(stderr, "Impossible d'écrire le livre d'ouvertures : %s.\n", fichier);
+        return 1;
+    }
+    printf("Livre d'ouvertures écrit dans %s : %u positions\n", fichier, livre->entete->nb_positions);
+
+    fermerLivre(livre);
+    free(creation.positions);
+    free(creation.nb_simus);
+    free(creation.nb_victoires);
+
+    return 0;
+}
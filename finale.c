@@ -0,0 +1,212 @@
+#include "finale.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+// Bornes des scores (aucun joueur ne peut gagner avant d'avoir posé LONGUEUR_ALIGNEMENT pions)
+#define SCORE_MIN (-NB_CASES / 2 + LONGUEUR_ALIGNEMENT - 1)
+#define SCORE_MAX ((NB_CASES + 1) / 2 - LONGUEUR_ALIGNEMENT + 1)
+
+/** Position du solveur : pions du joueur qui doit jouer et cases occupées */
+typedef struct {
+
+	Bitboard courant;
+	Bitboard masque;
+	int nb_coups;
+
+} PositionFinale;
+
+/** Retourne la i-ème colonne dans l'ordre d'exploration : du centre vers les bords */
+static inline int colonneOrdre(int i) {
+	return NB_COLONNES / 2 + (1 - 2 * (i % 2)) * (i + 1) / 2;
+}
+
+/** Retourne les cases jouables qui ne laissent pas l'adversaire gagner au coup suivant
+    (aucune si l'adversaire a deux menaces immédiates : la position est perdue) */
+static inline Bitboard coupsNonPerdants(PositionFinale * position) {
+	Bitboard jouables = casesJouables(position->masque);
+	Bitboard menaces = casesGagnantes(position->courant ^ position->masque, position->masque);
+	Bitboard forces = jouables & menaces;
+	if (forces != 0) {
+		if (forces & (forces - 1))      // deux menaces à parer : perdu
+			return 0;
+		jouables = forces;              // une menace : il faut la parer
+	}
+	// on ne joue pas sous une case gagnante de l'adversaire
+	return jouables & ~(menaces >> 1);
+}
+
+/** Joue la case (jouable) donnée */
+static inline void jouerCase(PositionFinale * position, Bitboard caseJouee) {
+	position->courant ^= position->masque;      // le joueur qui doit jouer change
+	position->masque |= caseJouee;
+	position->nb_coups++;
+}
+
+/** Clé de la position sur 56 bits (unique : le bit au dessus du dernier pion de chaque colonne code sa hauteur ;
+    hachée si le plateau occupe plus de 56 bits, les 8 bits restants des entrées de la table étant ceux du score) */
+static inline uint64_t cleFinale(PositionFinale * position) {
+#if NB_COLONNES * HAUTEUR_COLONNE <= 56
+	return position->courant + position->masque;
+#else
+	return hacherBitboard(position->courant + position->masque) >> 8;
+#endif
+}
+
+/** Retourne l'entrée de la table associée à la clé */
+static inline uint64_t * entreeTable(SolveurFinale * solveur, uint64_t cle) {
+	return &solveur->table[(cle * 0x9E3779B97F4A7C15ULL) >> (64 - FINALE_BITS_TABLE)];
+}
+
+/** Negamax avec élagage alpha-beta : retourne le score exact de la position s'il est entre alpha et beta,
+    sinon une borne (au plus alpha si le score est inférieur, au moins beta s'il est supérieur).
+    Le joueur qui doit jouer ne doit pas pouvoir gagner au coup suivant. */
+static int negamax(SolveurFinale * solveur, PositionFinale * position, int alpha, int beta) {
+	solveur->nb_noeuds++;
+	if (solveur->interrompu || (solveur->noeudsmax > 0 && solveur->nb_noeuds > solveur->noeudsmax)
+	    || budgetEpuise(&solveur->controle)) {
+		solveur->interrompu = true;
+		return 0;
+	}
+
+	Bitboard coups = coupsNonPerdants(position);
+	if (coups == 0)     // l'adversaire gagne au coup suivant
+		return -(NB_CASES - position->nb_coups) / 2;
+
+	if (position->nb_coups >= NB_CASES - 2)     // match nul (plus assez de cases pour gagner)
+		return 0;
+
+	// borne inférieure : l'adversaire ne peut pas gagner au coup suivant
+	int min = -(NB_CASES - 2 - position->nb_coups) / 2;
+	if (alpha < min) {
+		alpha = min;
+		if (alpha >= beta)
+			return alpha;
+	}
+
+	// borne supérieure : on ne peut pas gagner au coup suivant (ou celle conservée dans la table)
+	int max = (NB_CASES - 1 - position->nb_coups) / 2;
+	uint64_t cle = cleFinale(position);
+	uint64_t * entree = entreeTable(solveur, cle);
+	if ((*entree >> 8) == cle && (*entree & 0xFF) != 0)
+		max = (int)(*entree & 0xFF) + SCORE_MIN - 1;
+	if (beta > max) {
+		beta = max;
+		if (alpha >= beta)
+			return beta;
+	}
+
+	int i;
+	for (i = 0 ; i < NB_COLONNES ; i++) {
+		Bitboard caseJouee = coups & MASQUE_COLONNE(colonneOrdre(i));
+		if (caseJouee == 0)
+			continue;
+
+		PositionFinale positionEnfant = *position;
+		jouerCase(&positionEnfant, caseJouee);
+		int score = -negamax(solveur, &positionEnfant, -beta, -alpha);
+		if (solveur->interrompu)
+			return 0;
+
+		if (score >= beta)
+			return score;
+		if (score > alpha)
+			alpha = score;
+	}
+
+	// alpha est une borne supérieure du score de la position
+	// (une borne inférieure à SCORE_MIN, possible au début de la partie, n'apporte rien et n'est pas conservée :
+	// elle ne tiendrait pas dans l'octet du score)
+	if (alpha >= SCORE_MIN)
+		*entree = (cle << 8) | (uint64_t)(alpha - SCORE_MIN + 1);
+	return alpha;
+}
+
+/** Retourne le score exact de la position (recherches à fenêtre nulle en resserrant l'intervalle du score) */
+static int scoreExact(SolveurFinale * solveur, PositionFinale * position) {
+	int min = -(NB_CASES - position->nb_coups) / 2;
+	int max = (NB_CASES + 1 - position->nb_coups) / 2;
+
+	while (min < max && !solveur->interrompu) {
+		int milieu = min + (max - min) / 2;
+		// on explore d'abord les scores proches de 0 (les positions sont souvent proches du nul)
+		if (milieu <= 0 && min / 2 < milieu)
+			milieu = min / 2;
+		else if (milieu >= 0 && max / 2 > milieu)
+			milieu = max / 2;
+
+		int r = negamax(solveur, position, milieu, milieu + 1);
+		if (r <= milieu)
+			max = r;
+		else
+			min = r;
+	}
+	return min;
+}
+
+SolveurFinale * nouveauSolveur(void) {
+	SolveurFinale * solveur = (SolveurFinale *)malloc(sizeof(SolveurFinale));
+	solveur->table = (uint64_t *)calloc((size_t)1 << FINALE_BITS_TABLE, sizeof(uint64_t));
+	if (solveur->table == NULL) {
+		fprintf(stderr, "Mémoire insuffisante pour allouer la table du solveur de fin de partie.\n");
+		exit(EXIT_FAILURE);
+	}
+	solveur->nb_noeuds = 0;
+	solveur->noeudsmax = 0;
+	solveur->interrompu = false;
+
+	return solveur;
+}
+
+void freeSolveur(SolveurFinale * solveur) {
+	free(solveur->table);
+	free(solveur);
+}
+
+bool resoudreFinale(SolveurFinale * solveur, Etat * etat, BudgetTemps * budget, long long noeudsmax, int * colonne, int * score) {
+	PositionFinale position = { etat->pions[etat->joueur], etat->masque, etat->nb_coups };
+	int i;
+
+	solveur->nb_noeuds = 0;
+	solveur->noeudsmax = noeudsmax;
+	solveur->interrompu = false;
+	initControle(&solveur->controle, budget);
+
+	// Coup gagnant immédiat
+	Bitboard gagnants = casesGagnantes(position.courant, position.masque) & casesJouables(position.masque);
+	for (i = 0 ; i < NB_COLONNES ; i++) {
+		if (gagnants & MASQUE_COLONNE(colonneOrdre(i))) {
+			*colonne = colonneOrdre(i);
+			*score = (NB_CASES + 1 - position.nb_coups) / 2;
+			return true;
+		}
+	}
+
+	// Si tous les coups sont perdants, on joue le premier coup possible
+	Bitboard coups = coupsNonPerdants(&position);
+	if (coups == 0) {
+		Bitboard jouables = casesJouables(position.masque);
+		for (i = 0 ; (jouables & MASQUE_COLONNE(colonneOrdre(i))) == 0 ; i++)
+			;
+		*colonne = colonneOrdre(i);
+		*score = -(NB_CASES - position.nb_coups) / 2;
+		return true;
+	}
+
+	// Score exact de la position, puis premier coup (du centre vers les bords) qui l'atteint
+	*score = scoreExact(solveur, &position);
+	for (i = 0 ; i < NB_COLONNES && !solveur->interrompu ; i++) {
+		Bitboard caseJouee = coups & MASQUE_COLONNE(colonneOrdre(i));
+		if (caseJouee == 0)
+			continue;
+
+		PositionFinale positionEnfant = position;
+		jouerCase(&positionEnfant, caseJouee);
+		// le score du coup est au moins score si celui de l'adversaire est au plus -score
+		if (negamax(solveur, &positionEnfant, -*score, -*score + 1) <= -*score && !solveur->interrompu) {
+			*colonne = colonneOrdre(i);
+			return true;
+		}
+	}
+	return false;
+}
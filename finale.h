@@ -0,0 +1,50 @@
+#ifndef FINALE_H_INCLUDED
+#define FINALE_H_INCLUDED
+
+#include "puissance4.h"
+#include "chrono.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+    Solveur exact de fin de partie : negamax avec élagage alpha-beta sur les bitboards,
+    coups explorés du centre vers les bords, coups perdants (qui laissent l'adversaire gagner
+    au coup suivant) écartés, et table de transposition propre au solveur.
+    Le score d'une position est celui du joueur qui doit jouer :
+    positif s'il gagne (d'autant plus grand qu'il gagne vite), négatif s'il perd, nul pour un match nul.
+*/
+
+// Nb de cases vides en dessous duquel (ou égal) le solveur remplace MCTS par défaut
+#define CASES_FINALE_DEFAUT 20
+
+// Nb d'entrées de la table de transposition du solveur (log2)
+#define FINALE_BITS_TABLE 21
+
+// Nb de positions explorées par le solveur dans le temps d'une itération de MCTS (environ) :
+// convertit une limite en nombre d'itérations en limite du nombre de positions
+#define FINALE_NOEUDS_PAR_ITERATION 20
+
+/** Définition du type SolveurFinale */
+typedef struct {
+
+	uint64_t * table;       // entrées : clé de la position (bits de poids fort) et borne supérieure de son score (octet de poids faible, 0 si vide)
+	long long nb_noeuds;    // nb de positions explorées par la dernière résolution
+	long long noeudsmax;    // nb maximal de positions de la résolution en cours (pas de limite si nul ou négatif)
+	ControleTemps controle; // contrôle du budget de la résolution en cours
+	bool interrompu;        // vrai si la dernière résolution a été interrompue faute de temps
+
+} SolveurFinale;
+
+/** Créer un nouveau solveur (table de transposition vide) */
+SolveurFinale * nouveauSolveur(void);
+
+/** Libère la mémoire du solveur */
+void freeSolveur(SolveurFinale * solveur);
+
+/** Cherche le meilleur coup du joueur qui doit jouer dans la position (non terminale)
+    et range dans colonne ce coup et dans score le score exact de la position.
+    Retourne false si le budget de temps ou de positions (noeudsmax, pas de limite si nul ou négatif)
+    est épuisé avant la fin de la résolution. */
+bool resoudreFinale(SolveurFinale * solveur, Etat * etat, BudgetTemps * budget, long long noeudsmax, int * colonne, int * score);
+
+#endif // FINALE_H_INCLUDED
@@ -0,0 +1,169 @@
+#include "livre.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/** Retourne l'emplacement de départ de la recherche d'une clé (hachage multiplicatif) */
+static uint32_t emplacementDepart(LivreOuvertures * livre, uint64_t cle) {
+	return (uint32_t)((cle * 0x9E3779B97F4A7C15ULL) >> (64 - livre->entete->bits));
+}
+
+/** Retourne le bitboard symétrique par rapport à la colonne du milieu */
+static Bitboard miroir(Bitboard b) {
+	Bitboard colonne = ((Bitboard)1 << HAUTEUR_COLONNE) - 1;
+	Bitboard resultat = 0;
+	int c;
+	for (c = 0 ; c < NB_COLONNES ; c++)
+		resultat |= ((b >> (c * HAUTEUR_COLONNE)) & colonne) << ((NB_COLONNES - 1 - c) * HAUTEUR_COLONNE);
+	return resultat;
+}
+
+uint64_t cleLivre(Etat * etat, bool * symetrique) {
+	Etat etatMiroir = *etat;
+	etatMiroir.pions[0] = miroir(etat->pions[0]);
+	etatMiroir.pions[1] = miroir(etat->pions[1]);
+	etatMiroir.masque = miroir(etat->masque);
+
+	uint64_t cle = clePosition(etat);
+	uint64_t cleMiroir = clePosition(&etatMiroir);
+	*symetrique = cleMiroir < cle;
+	return *symetrique ? cleMiroir : cle;
+}
+
+LivreOuvertures * ouvrirLivre(const char * fichier) {
+	int descripteur = open(fichier, O_RDONLY);
+	if (descripteur < 0) {
+		fprintf(stderr, "Impossible d'ouvrir le livre d'ouvertures : %s.\n", fichier);
+		return NULL;
+	}
+
+	struct stat infos;
+	if (fstat(descripteur, &infos) != 0 || (size_t)infos.st_size < sizeof(EnteteLivre)) {
+		fprintf(stderr, "Le fichier %s n'est pas un livre d'ouvertures valide pour ce plateau.\n", fichier);
+		close(descripteur);
+		return NULL;
+	}
+	void * donnees = mmap(NULL, (size_t)infos.st_size, PROT_READ, MAP_SHARED, descripteur, 0);
+	close(descripteur);     // la projection reste valide après la fermeture du fichier
+	if (donnees == MAP_FAILED) {
+		fprintf(stderr, "Impossible de projeter en mémoire le livre d'ouvertures : %s.\n", fichier);
+		return NULL;
+	}
+
+	// Vérification de l'entête (le livre doit avoir été créé pour ce plateau) et de la taille du fichier
+	EnteteLivre * entete = (EnteteLivre *)donnees;
+	size_t taille = (size_t)infos.st_size;
+	if (memcmp(entete->magie, LIVRE_MAGIE, sizeof(entete->magie)) != 0 || entete->version != LIVRE_VERSION
+	    || entete->nb_lignes != NB_LIGNES || entete->nb_colonnes != NB_COLONNES || entete->alignement != LONGUEUR_ALIGNEMENT
+	    || entete->bits < 1 || entete->bits > 31
+	    || taille != sizeof(EnteteLivre) + ((size_t)1 << entete->bits) * sizeof(EntreeLivre)
+	    || entete->nb_positions >= ((uint32_t)1 << entete->bits)) {  // table pleine : chercherLivre ne s'arrêterait pas
+		fprintf(stderr, "Le fichier %s n'est pas un livre d'ouvertures valide pour ce plateau.\n", fichier);
+		munmap(donnees, taille);
+		return NULL;
+	}
+
+	LivreOuvertures * livre = (LivreOuvertures *)malloc(sizeof(LivreOuvertures));
+	livre->entete = entete;
+	livre->entrees = (EntreeLivre *)(entete + 1);
+	livre->taille = taille;
+
+	return livre;
+}
+
+LivreOuvertures * nouveauLivre(uint32_t nbPositions, int profondeur) {
+	// la table est au plus à moitié pleine
+	uint32_t bits = 1;
+	while (((uint32_t)1 << bits) < 2 * nbPositions)
+		bits++;
+
+	LivreOuvertures * livre = (LivreOuvertures *)malloc(sizeof(LivreOuvertures));
+	livre->entete = (EnteteLivre *)calloc(1, sizeof(EnteteLivre));
+	livre->entrees = (EntreeLivre *)calloc((size_t)1 << bits, sizeof(EntreeLivre));
+	if (livre->entete == NULL || livre->entrees == NULL) {
+		fprintf(stderr, "Mémoire insuffisante pour allouer le livre d'ouvertures.\n");
+		exit(EXIT_FAILURE);
+	}
+	livre->taille = 0;
+
+	memcpy(livre->entete->magie, LIVRE_MAGIE, sizeof(LIVRE_MAGIE));
+	livre->entete->version = LIVRE_VERSION;
+	livre->entete->nb_lignes = NB_LIGNES;
+	livre->entete->nb_colonnes = NB_COLONNES;
+	livre->entete->alignement = LONGUEUR_ALIGNEMENT;
+	livre->entete->bits = bits;
+	livre->entete->nb_positions = 0;
+	livre->entete->profondeur = profondeur;
+
+	return livre;
+}
+
+bool chercherLivre(LivreOuvertures * livre, Etat * etat, EntreeLivre * entree) {
+	bool symetrique;
+	uint64_t cle = cleLivre(etat, &symetrique);
+	uint32_t masque = ((uint32_t)1 << livre->entete->bits) - 1;
+	uint32_t i = emplacementDepart(livre, cle);
+
+	// on parcourt les emplacements à partir de l'emplacement de départ jusqu'à un emplacement libre
+	while (livre->entrees[i].cle != 0) {
+		if (livre->entrees[i].cle == cle) {
+			EntreeLivre * trouvee = &livre->entrees[i];
+			int c;
+			entree->cle = cle;
+			for (c = 0 ; c < NB_COLONNES ; c++) {
+				int colonne = symetrique ? NB_COLONNES - 1 - c : c;
+				entree->nb_simus[c] = trouvee->nb_simus[colonne];
+				entree->nb_victoires[c] = trouvee->nb_victoires[colonne];
+			}
+			return true;
+		}
+		i = (i + 1) & masque;
+	}
+	return false;
+}
+
+void ajouterLivre(LivreOuvertures * livre, Etat * etat, uint32_t nb_simus[LARGEUR_MAX], uint32_t nb_victoires[LARGEUR_MAX]) {
+	bool symetrique;
+	uint64_t cle = cleLivre(etat, &symetrique);
+	uint32_t masque = ((uint32_t)1 << livre->entete->bits) - 1;
+	uint32_t i = emplacementDepart(livre, cle);
+
+	while (livre->entrees[i].cle != 0)
+		i = (i + 1) & masque;
+
+	EntreeLivre * entree = &livre->entrees[i];
+	int c;
+	entree->cle = cle;
+	for (c = 0 ; c < NB_COLONNES ; c++) {
+		int colonne = symetrique ? NB_COLONNES - 1 - c : c;
+		entree->nb_simus[colonne] = nb_simus[c];
+		entree->nb_victoires[colonne] = nb_victoires[c];
+	}
+	livre->entete->nb_positions++;
+}
+
+bool ecrireLivre(LivreOuvertures * livre, const char * fichier) {
+	FILE * f = fopen(fichier, "wb");
+	if (f == NULL)
+		return false;
+
+	size_t nbEntrees = (size_t)1 << livre->entete->bits;
+	bool correct = fwrite(livre->entete, sizeof(EnteteLivre), 1, f) == 1
+	            && fwrite(livre->entrees, sizeof(EntreeLivre), nbEntrees, f) == nbEntrees;
+	return fclose(f) == 0 && correct;
+}
+
+void fermerLivre(LivreOuvertures * livre) {
+	if (livre->taille > 0)
+		munmap(livre->entete, livre->taille);
+	else {
+		free(livre->entete);
+		free(livre->entrees);
+	}
+	free(livre);
+}
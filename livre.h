@@ -0,0 +1,81 @@
+#ifndef LIVRE_H_INCLUDED
+#define LIVRE_H_INCLUDED
+
+#include "puissance4.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+    Livre d'ouvertures : statistiques des coups de l'ordinateur calculées hors ligne
+    (longues recherches MCTS sur toutes les positions des premiers coups de la partie).
+    Le fichier est une table à adressage ouvert indexée par la clé de la position,
+    projetée en mémoire telle quelle (sans lecture ni allocation) à l'ouverture du livre.
+    Une position et sa symétrique (par rapport à la colonne du milieu) partagent la même entrée.
+    Le fichier est écrit dans l'ordre des octets de la machine qui l'a créé.
+*/
+
+// Format du fichier
+#define LIVRE_MAGIE "P4LIVRE"   // signature du fichier (8 octets avec le caractère nul)
+#define LIVRE_VERSION 2     // (version 2 : longueur de l'alignement dans l'entête)
+
+/** Entête du fichier (64 octets) */
+typedef struct {
+
+	char magie[8];              // LIVRE_MAGIE
+	uint32_t version;           // LIVRE_VERSION
+	uint32_t nb_lignes;         // dimensions du plateau pour lequel le livre a été créé
+	uint32_t nb_colonnes;
+	uint32_t alignement;        // nb de pions à aligner pour gagner
+	uint32_t bits;              // log2 du nb d'entrées de la table
+	uint32_t nb_positions;      // nb d'entrées occupées
+	uint32_t profondeur;        // nb maximal de coups joués dans les positions du livre
+	uint32_t reserve[7];
+
+} EnteteLivre;
+
+/** Entrée du livre : statistiques des coups de l'ordinateur dans une position (64 octets au Puissance 4) */
+typedef struct {
+
+	uint64_t cle;                           // clé de la position (voir clePosition), 0 si l'entrée est libre
+	uint32_t nb_simus[LARGEUR_MAX];         // nb de simulations de chaque coup (0 si le coup n'est pas possible)
+	uint32_t nb_victoires[LARGEUR_MAX];     // nb de victoires de l'ordinateur après chaque coup
+
+} EntreeLivre;
+
+/** Définition du type LivreOuvertures (les entrées suivent l'entête) */
+typedef struct {
+
+	EnteteLivre * entete;
+	EntreeLivre * entrees;
+	size_t taille;          // taille de la projection du fichier (0 pour un livre en cours de création)
+
+} LivreOuvertures;
+
+/** Retourne la clé sous laquelle la position est rangée dans le livre
+    (la plus petite des clés de la position et de sa symétrique)
+    et met symetrique à vrai si c'est celle de la symétrique */
+uint64_t cleLivre(Etat * etat, bool * symetrique);
+
+/** Ouvre le livre contenu dans le fichier en le projetant en mémoire (en lecture seule)
+    et retourne NULL (après avoir affiché l'erreur) si le fichier est illisible ou n'est pas un livre valide */
+LivreOuvertures * ouvrirLivre(const char * fichier);
+
+/** Créer un nouveau livre vide (en mémoire) pouvant contenir nbPositions positions */
+LivreOuvertures * nouveauLivre(uint32_t nbPositions, int profondeur);
+
+/** Cherche dans le livre la position (où l'ordinateur doit jouer)
+    et range dans entree les statistiques de ses coups (dans l'orientation de la position).
+    Retourne false si la position est absente du livre. */
+bool chercherLivre(LivreOuvertures * livre, Etat * etat, EntreeLivre * entree);
+
+/** Ajoute au livre les statistiques des coups d'une position (absente du livre et qui doit y tenir) */
+void ajouterLivre(LivreOuvertures * livre, Etat * etat, uint32_t nb_simus[LARGEUR_MAX], uint32_t nb_victoires[LARGEUR_MAX]);
+
+/** Ecrit le livre dans le fichier et retourne false en cas d'erreur */
+bool ecrireLivre(LivreOuvertures * livre, const char * fichier);
+
+/** Ferme le livre (ou libère la mémoire d'un livre créé avec nouveauLivre) */
+void fermerLivre(LivreOuvertures * livre);
+
+#endif // LIVRE_H_INCLUDED
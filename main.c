@@ -6,6 +6,7 @@
 #include <stdbool.h>
 #include <getopt.h>
 #include <ctype.h>
+#include <time.h>
 
 int main(int argc, char **argv) {
 
@@ -15,6 +16,8 @@ int main(int argc, char **argv) {
                     0 : fonctionnement basique de l'algorithme MCTS avec UCB (UCT) (les simulations sont réalisées au hasard).
      (par défaut)   1 : (QUESTION 3 :) amélioration des simulations consistant à toujours choisir un coup gagnant lorsque cela est possible.
                     2 : lorsqu'un coup gagnant est possible, l'algorithme n'est pas utilisé et le coup est joué directement.
+                    3 : MCTS-Solver : les résultats prouvés (gain, perte, nul) sont remontés dans l'arbre et les sous-arbres résolus ne sont plus explorés.
+                    4 : comme 3, les simulations jouant pour chaque joueur un coup gagnant, sinon le blocage d'un coup gagnant de l'adversaire, sinon un coup au hasard.
     *********************************************/
     int optimisationLevel = 1;
 
@@ -27,6 +30,20 @@ int main(int argc, char **argv) {
     ****************************************/
     int verboseLevel = 1;
 
+    int nbThreads = 1;  // nombre de threads pour MCTS
+    Parallelisation parallelisation = RACINE;   // un arbre par thread (ou un arbre partagé, ou simulations réparties)
+    int simulationsParFeuille = 1;  // nombre de simulations par noeud développé
+    int noeudsMax = -1;             // nombre maximal de noeuds des arbres de recherche (non limité par défaut)
+    FILE * statistiques = NULL;     // fichier d'export des statistiques de chaque recherche (aucun par défaut)
+    LivreOuvertures * livre = NULL; // livre d'ouvertures consulté avant chaque recherche (aucun par défaut)
+    bool reflexion = false;         // réflexion de l'ordinateur pendant le tour de l'humain (désactivée par défaut)
+    int casesFinale = CASES_FINALE_DEFAUT;  // nb de cases vides à partir duquel le solveur exact remplace MCTS
+
+    // graine du générateur aléatoire (tirée à partir de l'heure si elle n'est pas précisée)
+    struct timespec maintenant;
+    clock_gettime(CLOCK_REALTIME, &maintenant);
+    uint64_t graine = (uint64_t)maintenant.tv_sec * 1000000000ULL + maintenant.tv_nsec;
+
     // Valeurs par défaut
     // temps : 5s
     // iterations : non limité
@@ -36,6 +53,9 @@ int main(int argc, char **argv) {
     MethodeChoixCoup methodeChoix = ROBUSTE; // méthode du choix du meilleur coup à la fin de MCTS
     bool printHelp = false;
     bool robustFlag = false, maxFlag = false, timeFlag = false;
+    bool partageFlag = false, feuillesFlag = false;
+    bool noeudsFlag = false, memoireFlag = false;
+    bool finaleFlag = false, alphaBetaFlag = false;
 
     // Spécification des options
     static struct option long_options[] = {
@@ -50,6 +70,28 @@ int main(int argc, char **argv) {
         {"optimisation", required_argument, 0, 'o'},
         {"optimization", required_argument, 0, 'o'},
         {"verbose", required_argument, 0, 'v'},
+        {"threads", required_argument, 0, 'p'},
+        {"arbre-partage", no_argument, 0, 's'},
+        {"shared-tree", no_argument, 0, 's'},
+        {"feuilles", no_argument, 0, 'f'},
+        {"leaf-parallel", no_argument, 0, 'f'},
+        {"simulations-par-feuille", required_argument, 0, 'k'},
+        {"rollouts-per-leaf", required_argument, 0, 'k'},
+        {"graine", required_argument, 0, 'g'},
+        {"seed", required_argument, 0, 'g'},
+        {"noeuds-max", required_argument, 0, 'n'},
+        {"max-nodes", required_argument, 0, 'n'},
+        {"memoire-max", required_argument, 0, 'M'},
+        {"max-memory", required_argument, 0, 'M'},
+        {"statistiques", required_argument, 0, 'e'},
+        {"stats", required_argument, 0, 'e'},
+        {"livre", required_argument, 0, 'b'},
+        {"book", required_argument, 0, 'b'},
+        {"reflexion", no_argument, 0, 'P'},
+        {"ponder", no_argument, 0, 'P'},
+        {"finale", required_argument, 0, 'z'},
+        {"endgame", required_argument, 0, 'z'},
+        {"alpha-beta", no_argument, 0, 'a'},
         {0, 0, 0, 0}
     };
 
@@ -57,7 +99,7 @@ int main(int argc, char **argv) {
     opterr = 0;
     int opt = 0;
 
-    while ( (opt = getopt_long (argc, argv, "hmrt:i:o:v:", long_options, &option_index)) != -1) {
+    while ( (opt = getopt_long (argc, argv, "hmrt:i:o:v:p:sfk:g:n:M:e:b:Pz:a", long_options, &option_index)) != -1) {
         int intResult = 0;
         double doubleResult = 0;
 
@@ -134,9 +176,152 @@ int main(int argc, char **argv) {
                 }
                 break;
 
+            case 'p' :
+                if (convertStringToInt(optarg, &intResult) && intResult > 0 && intResult <= NB_THREADS_MAX)
+                    nbThreads = intResult;
+                else {
+                    fprintf(stderr, "Argument incorrect : %s.\n", optarg);
+                    fprintf(stderr, "L'option -p requiert un nombre entier compris entre 1 et %d en argument.\n", NB_THREADS_MAX);
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                break;
+
+            case 's' :
+                if (feuillesFlag) {   // Si le choix de la parallélisation aux feuilles a déjà été fait
+                    fprintf(stderr, "Conflit d'arguments : -%c.\n", opt);
+                    fprintf(stderr, "Les options -s et -f ne peuvent être utilisées en même temps.\n");
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                    partageFlag = true;
+                    parallelisation = ARBRE_PARTAGE;
+                break;
+
+            case 'f' :
+                if (partageFlag) {   // Si le choix de l'arbre partagé a déjà été fait
+                    fprintf(stderr, "Conflit d'arguments : -%c.\n", opt);
+                    fprintf(stderr, "Les options -s et -f ne peuvent être utilisées en même temps.\n");
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                    feuillesFlag = true;
+                    parallelisation = FEUILLES;
+                break;
+
+            case 'k' :
+                if (convertStringToInt(optarg, &intResult) && intResult > 0)
+                    simulationsParFeuille = intResult;
+                else {
+                    fprintf(stderr, "Argument incorrect : %s.\n", optarg);
+                    fprintf(stderr, "L'option -k requiert un nombre entier positif non nul en argument.\n");
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                break;
+
+            case 'g' :
+                if (!convertStringToUInt64(optarg, &graine)) {
+                    fprintf(stderr, "Argument incorrect : %s.\n", optarg);
+                    fprintf(stderr, "L'option -g requiert un nombre entier positif ou nul en argument.\n");
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                break;
+
+            case 'n' :
+                if (memoireFlag) {   // Si la mémoire maximale a déjà été donnée
+                    fprintf(stderr, "Conflit d'arguments : -%c.\n", opt);
+                    fprintf(stderr, "Les options -n et -M ne peuvent être utilisées en même temps.\n");
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                if (convertStringToInt(optarg, &intResult) && intResult > 0) {
+                    noeudsMax = intResult;
+                    noeudsFlag = true;
+                }
+                else {
+                    fprintf(stderr, "Argument incorrect : %s.\n", optarg);
+                    fprintf(stderr, "L'option -n requiert un nombre entier positif non nul en argument.\n");
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                break;
+
+            case 'M' :
+                if (noeudsFlag) {   // Si le nombre de noeuds maximal a déjà été donné
+                    fprintf(stderr, "Conflit d'arguments : -%c.\n", opt);
+                    fprintf(stderr, "Les options -n et -M ne peuvent être utilisées en même temps.\n");
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                if (convertStringToDouble(optarg, &doubleResult) && doubleResult > 0) {
+                    noeudsMax = noeudsPourMemoire(doubleResult * 1024 * 1024);
+                    memoireFlag = true;
+                }
+                else {
+                    fprintf(stderr, "Argument incorrect : %s.\n", optarg);
+                    fprintf(stderr, "L'option -M requiert un nombre décimal (en Mo) positif non nul en argument.\n");
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                break;
+
+            case 'e' :
+                if (statistiques != NULL)
+                    fclose(statistiques);
+                statistiques = fopen(optarg, "w");
+                if (statistiques == NULL) {
+                    fprintf(stderr, "Impossible d'ouvrir le fichier de statistiques : %s.\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'b' :
+                if (livre != NULL)
+                    fermerLivre(livre);
+                livre = ouvrirLivre(optarg);
+                if (livre == NULL)
+                    return 1;
+                break;
+
+            case 'P' :
+                reflexion = true;
+                break;
+
+            case 'z' :
+                if (alphaBetaFlag) {   // Si le solveur a déjà été imposé pour toute la partie
+                    fprintf(stderr, "Conflit d'arguments : -%c.\n", opt);
+                    fprintf(stderr, "Les options -z et -a ne peuvent être utilisées en même temps.\n");
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                if (convertStringToInt(optarg, &intResult) && intResult >= 0 && intResult <= NB_CASES) {
+                    casesFinale = intResult;
+                    finaleFlag = true;
+                }
+                else {
+                    fprintf(stderr, "Argument incorrect : %s.\n", optarg);
+                    fprintf(stderr, "L'option -z requiert un nombre entier compris entre 0 et %d en argument.\n", NB_CASES);
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                break;
+
+            case 'a' :
+                if (finaleFlag) {   // Si le nombre de cases vides a déjà été donné
+                    fprintf(stderr, "Conflit d'arguments : -%c.\n", opt);
+                    fprintf(stderr, "Les options -z et -a ne peuvent être utilisées en même temps.\n");
+                    fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                    return 1;
+                }
+                casesFinale = NB_CASES;
+                alphaBetaFlag = true;
+                break;
+
             case '?':
                 // Argument requis
-                if (optopt == 't' || optopt == 'o' || optopt == 'v')
+                if (optopt == 't' || optopt == 'i' || optopt == 'o' || optopt == 'v' || optopt == 'p' || optopt == 'k' || optopt == 'g' || optopt == 'n' || optopt == 'M' || optopt == 'e' || optopt == 'b' || optopt == 'z')
                     fprintf(stderr, "Argument requis pour l'option -%c.\n", optopt);
                 else if(isprint(optopt))
                     fprintf (stderr, "Option inconnu : `-%c'.\n", optopt);
@@ -166,6 +351,8 @@ int main(int argc, char **argv) {
                 "\n             0 : fonctionnement basique de l'algorithme MCTS avec UCB (UCT) (les simulations sont réalisées au hasard)."
                 "\n(par défaut) 1 : (Question 3) amélioration des simulations consistant à toujours choisir un coup gagnant lorsque cela est possible."
                 "\n             2 : lorsqu'un coup gagnant est possible, l'algorithme n'est pas utilisé et le coup est joué directement."
+                "\n             3 : MCTS-Solver : les résultats prouvés (gain, perte, nul) sont remontés dans l'arbre et les sous-arbres résolus ne sont plus explorés."
+                "\n             4 : comme 3, les simulations jouant pour chaque joueur un coup gagnant, sinon le blocage d'un coup gagnant de l'adversaire, sinon un coup au hasard."
 
                 "\n\n-v arg (ou --verbose) avec arg étant un nombre entier positif non nul."
                 "\nPermet de définir le niveau de verbosité du programme, c'est-à-dire :"
@@ -175,12 +362,61 @@ int main(int argc, char **argv) {
                 "\n             3 : affichage (à chaque coup de l’ordinateur) du nombre de simulations réalisées pour chaque coup."
                 "\n             4 : affichage (à chaque coup de l’ordinateur) de la moyenne des récompenses pour chaque coup."
 
+                "\n\n-p arg (ou --threads) avec arg étant un nombre entier positif non nul (1 par défaut)."
+                "\nPermet de définir le nombre de threads utilisés par l'algorithme MCTS (parallélisation à la racine :"
+                "\nchaque thread développe son propre arbre et les statistiques des coups sont sommées à la fin)."
+                "\nChaque thread réalise au plus le nombre d'itérations donné par -i."
+
+                "\n\n-s (ou --arbre-partage ou --shared-tree)"
+                "\nLes threads développent tous le même arbre au lieu d'un arbre chacun"
+                "\n(recherche plus profonde pour la même quantité de mémoire)."
+
+                "\n\n-f (ou --feuilles ou --leaf-parallel)"
+                "\nUn seul thread développe l'arbre, les simulations réalisées à partir de chaque noeud développé"
+                "\nétant réparties entre les threads (à utiliser avec -k)."
+
+                "\n\n-k arg (ou --simulations-par-feuille ou --rollouts-per-leaf) avec arg étant un nombre entier positif non nul (1 par défaut)."
+                "\nPermet de définir le nombre de simulations réalisées à partir de chaque noeud développé"
+                "\n(leurs résultats sont propagés en une seule fois). Ces simulations sont jouées au pas par lots, sur des registres vectoriels"
+                "\n(nettement plus rapide par simulation qu'une à une : par exemple -k 8)."
+
+                "\n\n-g arg (ou --graine ou --seed) avec arg étant un nombre entier positif ou nul."
+                "\nPermet de fixer la graine du générateur aléatoire (tirée à partir de l'heure par défaut)."
+                "\nAvec un seul thread et une limite en nombre d'itérations (-i), les parties sont alors reproductibles."
+
+                "\n\n-n arg (ou --noeuds-max ou --max-nodes) avec arg étant un nombre entier positif non nul (non limité par défaut)."
+                "\nPermet de définir le nombre maximal de noeuds des arbres de recherche : une fois atteint,"
+                "\nl'algorithme ne développe plus de noeud et affine les statistiques de l'arbre existant."
+
+                "\n\n-M arg (ou --memoire-max ou --max-memory) avec arg étant un nombre décimal positif non nul (en Mo)."
+                "\nComme -n, le nombre maximal de noeuds étant déduit de la mémoire donnée (arbres et table de transposition)."
+
+                "\n\n-e arg (ou --statistiques ou --stats) avec arg étant un nom de fichier."
+                "\nPermet d'exporter dans ce fichier les statistiques de chaque recherche, à raison d'une ligne JSON par coup de l'ordinateur"
+                "\n(cycles passés dans chaque phase, noeuds alloués, profondeurs maximale et moyenne, longueur moyenne des simulations, itérations par seconde)."
+
+                "\n\n-b arg (ou --livre ou --book) avec arg étant un nom de fichier (créé avec CreationLivre)."
+                "\nPermet de consulter ce livre d'ouvertures avant chaque recherche : si la position y est, le coup est joué immédiatement"
+                "\nà partir des statistiques du livre (choisi avec la méthode donnée)."
+
+                "\n\n-P (ou --reflexion ou --ponder)."
+                "\nPermet à l'ordinateur de continuer l'algorithme MCTS pendant le tour de l'humain (au plus pendant la limite de temps ou d'itérations d'un coup)."
+                "\nLe sous-arbre correspondant au coup de l'humain est conservé et la recherche continue à partir de celui-ci."
+
+                "\n\n-z arg (ou --finale ou --endgame) avec arg étant un nombre entier positif ou nul (%d par défaut)."
+                "\nLorsqu'il ne reste pas plus de arg cases vides, le coup est calculé par un solveur exact (alpha-beta) au lieu de l'algorithme MCTS"
+                "\n(dans la moitié de la limite de temps ou, sans limite de temps, en explorant au plus %d positions par itération de la moitié de la limite d'itérations ;"
+                "\nsi la résolution n'aboutit pas dans ce budget, l'algorithme MCTS est utilisé). 0 désactive le solveur."
+
+                "\n\n-a (ou --alpha-beta)."
+                "\nLe solveur exact calcule tous les coups de l'ordinateur (comme -z %d)."
+
                 "\n\nmethode : {-r (ou --robuste ou --robust) | -m (ou --max) } :"
 
                 "\n\nPermet de définir la méthode pour choisir le coup à jouer à la fin de l'algorithme MCTS :"
                 "\n(par défaut) -r pour robuste (coup avec le plus grand nombre de simulations)."
                 "\n             -m pour max (coup avec la plus grande moyenne des récompenses)."
-                "\n\n");
+                "\n\n", CASES_FINALE_DEFAUT, FINALE_NOEUDS_PAR_ITERATION, NB_CASES);
         return 0;
     }
 
@@ -188,6 +424,12 @@ int main(int argc, char **argv) {
     if (!timeFlag && iterations >= 0)
         temps = -1; // on enlève le temps de 5 secondes par défaut
 
+    Alea alea;
+    initAlea(&alea, graine);
+
+    ParametresMCTS parametres = { temps, iterations, methodeChoix, optimisationLevel,
+                                  nbThreads, parallelisation, simulationsParFeuille, noeudsMax, verboseLevel, statistiques, livre, casesFinale, &alea, NULL };
+
 	Coup * coup = NULL;
 	FinDePartie fin;
 
@@ -208,6 +450,10 @@ int main(int argc, char **argv) {
 		if ( etat->joueur == 0 ) {
 			// tour de l'humain
 
+            // l'ordinateur réfléchit pendant que l'humain choisit son coup (la réflexion est arrêtée par ordijoue_mcts)
+            if (reflexion)
+                ordireflechit_mcts(etat, &parametres);
+
             int coupPossible = 0;
 			do {
 				coup = demanderCoup();
@@ -221,7 +467,7 @@ int main(int argc, char **argv) {
 		else {
 			// tour de l'Ordinateur
 
-			ordijoue_mcts(etat, temps, iterations, methodeChoix, optimisationLevel, verboseLevel);
+			ordijoue_mcts(etat, &parametres);
 
 		}
 
@@ -238,7 +484,12 @@ int main(int argc, char **argv) {
 	else
 		printf( "** BRAVO, l'ordinateur a perdu  **\n");
 
+    libererArbreMCTS();
     free(etat);
+    if (statistiques != NULL)
+        fclose(statistiques);
+    if (livre != NULL)
+        fermerLivre(livre);
 
 	return 0;
 }
@@ -0,0 +1,460 @@
+#include "puissance4.h"
+#include "mcts.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/**
+    Match entre deux configurations de l'algorithme MCTS (moteurs A et B), sans interaction :
+    les parties sont jouées en parallèle et le premier joueur alterne d'une partie à l'autre.
+    A compiler avec :
+    gcc -o Match match.c puissance4.c mcts.c arene.c alea.c transposition.c chrono.c livre.c finale.c -lm -lpthread utils.c
+*/
+
+// Quantile de la loi normale pour les intervalles de confiance à 95 %
+#define QUANTILE_95 1.96
+
+// Nb d'itérations par coup d'un moteur pour lequel ni temps ni nombre d'itérations n'est précisé
+#define ITERATIONS_DEFAUT 10000
+
+// Nb maximal d'options d'un moteur
+#define NB_OPTIONS_MAX 32
+
+/** Match en cours (partagé entre les threads qui jouent les parties) */
+typedef struct {
+
+	ParametresMCTS parametres[2];   // configuration des moteurs A et B
+	bool reflexion[2];              // vrai si le moteur réfléchit pendant le tour de l'autre
+	int nbParties;
+	uint64_t graine;
+	int verboseLevel;
+
+	int prochainePartie;            // numéro de la prochaine partie à jouer
+
+	pthread_mutex_t verrou;         // protège les résultats
+	int victoires[2];               // nb de victoires de chaque moteur
+	int nuls;
+	long long nb_simulations[2];    // statistiques cumulées des recherches de chaque moteur
+	double temps[2];
+	int nb_recherches[2];
+	int nb_coups_livre[2];
+	int nb_coups_finale[2];
+
+} Match;
+
+/** Joue une partie entre les moteurs A et B (A commence si la partie est paire)
+    et retourne le numéro du moteur gagnant (-1 pour un match nul) */
+static int jouerPartie(Match * match, MoteurMCTS * moteurs[2], int partie) {
+    // Chaque moteur a son propre générateur, dont la graine ne dépend que de la partie
+    Alea alea[2];
+    ParametresMCTS parametres[2];
+    int m;
+    for (m = 0 ; m < 2 ; m++) {
+        initAlea(&alea[m], match->graine + 2 * (uint64_t)partie + m);
+        parametres[m] = match->parametres[m];
+        parametres[m].alea = &alea[m];
+    }
+
+    // Le moteur A joue les pions de l'ordinateur, le moteur B ceux de l'humain
+    // (B joue sur l'état inversé : l'algorithme joue toujours pour l'ordinateur)
+    Etat * etat = etat_initial();
+    etat->joueur = partie % 2 == 0 ? 1 : 0;
+
+    while (testFin(etat) == NON) {
+        Etat etatMoteur = *etat;
+        Coup coup;
+        m = etat->joueur == 1 ? 0 : 1;
+        if (m == 1)
+            inverserJoueurs(&etatMoteur);
+        coup = jouerCoupMCTS(moteurs[m], &etatMoteur, &parametres[m]);
+        jouerCoup(etat, &coup);
+
+        // Le moteur qui vient de jouer réfléchit pendant le tour de l'autre (sur sa propre vue de l'état)
+        if (match->reflexion[m])
+            commencerReflexion(moteurs[m], &etatMoteur, &parametres[m]);
+    }
+    for (m = 0 ; m < 2 ; m++)
+        arreterReflexion(moteurs[m]);
+
+    FinDePartie fin = testFin(etat);
+    free(etat);
+
+    if (fin == ORDI_GAGNE)
+        return 0;
+    if (fin == HUMAIN_GAGNE)
+        return 1;
+    return -1;
+}
+
+/** Boucle d'un thread : joue des parties jusqu'à ce que toutes aient été jouées */
+static void * threadMatch(void * arg) {
+    Match * match = (Match *)arg;
+    MoteurMCTS * moteurs[2] = { nouveauMoteur(), nouveauMoteur() };
+    int partie, m;
+
+    while ( (partie = __atomic_fetch_add(&match->prochainePartie, 1, __ATOMIC_RELAXED)) < match->nbParties ) {
+        int gagnant = jouerPartie(match, moteurs, partie);
+
+        pthread_mutex_lock(&match->verrou);
+        if (gagnant < 0)
+            match->nuls++;
+        else
+            match->victoires[gagnant]++;
+        if (match->verboseLevel >= 1)
+            printf("Partie %d (%c commence) : %s\n", partie + 1, partie % 2 == 0 ? 'A' : 'B',
+                   gagnant < 0 ? "match nul" : (gagnant == 0 ? "A gagne" : "B gagne"));
+        pthread_mutex_unlock(&match->verrou);
+    }
+
+    pthread_mutex_lock(&match->verrou);
+    for (m = 0 ; m < 2 ; m++) {
+        match->nb_simulations[m] += moteurs[m]->nb_simulations;
+        match->temps[m] += moteurs[m]->temps;
+        match->nb_recherches[m] += moteurs[m]->nb_recherches;
+        match->nb_coups_livre[m] += moteurs[m]->nb_coups_livre;
+        match->nb_coups_finale[m] += moteurs[m]->nb_coups_finale;
+        freeMoteur(moteurs[m]);
+    }
+    pthread_mutex_unlock(&match->verrou);
+
+    return NULL;
+}
+
+/** Lit les options d'un moteur (mêmes options que Puissance4) données sous la forme d'une chaîne
+    (reflexion est mis à vrai si le moteur doit réfléchir pendant le tour de l'autre)
+    et retourne false si elles sont incorrectes */
+static bool lireOptionsMoteur(char * options, char nom, ParametresMCTS * parametres, bool * reflexion) {
+    char copie[1024];
+    char * argv[NB_OPTIONS_MAX + 1];
+    int argc = 0;
+
+    snprintf(copie, sizeof(copie), "%s", options);
+    argv[argc++] = "moteur";
+    char * mot = strtok(copie, " \t");
+    while (mot != NULL && argc < NB_OPTIONS_MAX) {
+        argv[argc++] = mot;
+        mot = strtok(NULL, " \t");
+    }
+    argv[argc] = NULL;
+
+    bool timeFlag = false, iterationsFlag = false;
+    int opt;
+    optind = 0;     // réinitialise getopt pour cette nouvelle liste d'options
+    while ( (opt = getopt(argc, argv, "mrt:i:o:p:sfk:n:b:Pz:a")) != -1 ) {
+        int intResult = 0;
+        double doubleResult = 0;
+        bool correct = true;
+
+        switch (opt) {
+            case 'm' :
+                parametres->methodeChoix = MAX;
+                break;
+            case 'r' :
+                parametres->methodeChoix = ROBUSTE;
+                break;
+            case 't' :
+                correct = convertStringToDouble(optarg, &doubleResult) && doubleResult > 0;
+                parametres->tempsmax = doubleResult;
+                timeFlag = true;
+                break;
+            case 'i' :
+                correct = convertStringToInt(optarg, &intResult) && intResult > 0;
+                parametres->iterationsmax = intResult;
+                iterationsFlag = true;
+                break;
+            case 'o' :
+                correct = convertStringToInt(optarg, &intResult) && intResult >= 0;
+                parametres->optimisationLevel = intResult;
+                break;
+            case 'p' :
+                correct = convertStringToInt(optarg, &intResult) && intResult > 0 && intResult <= NB_THREADS_MAX;
+                parametres->nbThreads = intResult;
+                break;
+            case 's' :
+                parametres->parallelisation = ARBRE_PARTAGE;
+                break;
+            case 'f' :
+                parametres->parallelisation = FEUILLES;
+                break;
+            case 'k' :
+                correct = convertStringToInt(optarg, &intResult) && intResult > 0;
+                parametres->simulationsParFeuille = intResult;
+                break;
+            case 'n' :
+                correct = convertStringToInt(optarg, &intResult) && intResult > 0;
+                parametres->noeudsmax = intResult;
+                break;
+            case 'b' :
+                if (parametres->livre != NULL)
+                    fermerLivre(parametres->livre);
+                parametres->livre = ouvrirLivre(optarg);
+                correct = parametres->livre != NULL;
+                break;
+            case 'P' :
+                *reflexion = true;
+                break;
+            case 'z' :
+                correct = convertStringToInt(optarg, &intResult) && intResult >= 0 && intResult <= NB_CASES;
+                parametres->casesFinale = intResult;
+                break;
+            case 'a' :
+                parametres->casesFinale = NB_CASES;
+                break;
+            default :
+                correct = false;
+                break;
+        }
+
+        if (!correct) {
+            fprintf(stderr, "Option incorrecte pour le moteur %c : %s.\n", nom, options);
+            return false;
+        }
+    }
+    if (optind < argc) {
+        fprintf(stderr, "Argument inattendu pour le moteur %c : %s.\n", nom, argv[optind]);
+        return false;
+    }
+
+    if (!timeFlag && !iterationsFlag)
+        parametres->iterationsmax = ITERATIONS_DEFAUT;
+
+    return true;
+}
+
+/** Borne de l'intervalle de confiance de Wilson (à 95 %) d'une proportion de k succès sur n essais
+    (signe : -1 pour la borne inférieure, 1 pour la borne supérieure) */
+static double borneWilson(int k, int n, int signe) {
+    double p = (double)k / n, z = QUANTILE_95;
+    double centre = p + z * z / (2 * n);
+    double ecart = z * sqrt(p * (1 - p) / n + z * z / (4.0 * n * n));
+    double borne = (centre + signe * ecart) / (1 + z * z / n);
+    return borne < 0 ? 0 : (borne > 1 ? 1 : borne);
+}
+
+/** Différence Elo correspondant à un score (entre 0 et 1) */
+static double differenceElo(double score) {
+    if (score <= 0)
+        return -INFINITY;
+    if (score >= 1)
+        return INFINITY;
+    return -400 * log10(1 / score - 1);
+}
+
+/** Affiche une proportion de résultats et son intervalle de confiance */
+static void afficheProportion(char * nom, int k, int n) {
+    printf("%s : %5d  (%5.1f %%, IC 95 %% : [%5.1f %% ; %5.1f %%])\n", nom, k,
+           100.0 * k / n, 100 * borneWilson(k, n, -1), 100 * borneWilson(k, n, 1));
+}
+
+int main(int argc, char **argv) {
+
+    Match match;
+    int m;
+
+    // Valeurs par défaut des moteurs : méthode robuste, optimisation 1, 1 thread, solveur exact à partir de CASES_FINALE_DEFAUT cases vides
+    // (ITERATIONS_DEFAUT itérations par coup si ni le temps ni le nombre d'itérations n'est précisé)
+    for (m = 0 ; m < 2 ; m++) {
+        ParametresMCTS parametres = { -1, -1, ROBUSTE, 1, 1, RACINE, 1, -1, 0, NULL, NULL, CASES_FINALE_DEFAUT, NULL, NULL };
+        match.parametres[m] = parametres;
+        match.reflexion[m] = false;
+    }
+    match.nbParties = 100;
+    match.verboseLevel = 0;
+    int nbThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nbThreads < 1)
+        nbThreads = 1;
+
+    struct timespec maintenant;
+    clock_gettime(CLOCK_REALTIME, &maintenant);
+    match.graine = (uint64_t)maintenant.tv_sec * 1000000000ULL + maintenant.tv_nsec;
+
+    char * options[2] = { "", "" };
+    bool printHelp = false;
+
+    static struct option long_options[] = {
+        {"help", no_argument, 0, 'h'},
+        {"parties", required_argument, 0, 'N'},
+        {"games", required_argument, 0, 'N'},
+        {"jobs", required_argument, 0, 'j'},
+        {"graine", required_argument, 0, 'g'},
+        {"seed", required_argument, 0, 'g'},
+        {"verbose", required_argument, 0, 'v'},
+        {0, 0, 0, 0}
+    };
+
+    int option_index = 0;
+    opterr = 0;
+    int opt = 0;
+
+    while ( (opt = getopt_long (argc, argv, "hN:j:g:v:A:B:", long_options, &option_index)) != -1) {
+        int intResult = 0;
+
+        switch (opt) {
+            case 'h' :
+                printHelp = true;
+                break;
+
+            case 'N' :
+                if (convertStringToInt(optarg, &intResult) && intResult > 0)
+                    match.nbParties = intResult;
+                else {
+                    fprintf(stderr, "Argument incorrect : %s.\n", optarg);
+                    fprintf(stderr, "L'option -N requiert un nombre entier positif non nul en argument.\n");
+                    return 1;
+                }
+                break;
+
+            case 'j' :
+                if (convertStringToInt(optarg, &intResult) && intResult > 0)
+                    nbThreads = intResult;
+                else {
+                    fprintf(stderr, "Argument incorrect : %s.\n", optarg);
+                    fprintf(stderr, "L'option -j requiert un nombre entier positif non nul en argument.\n");
+                    return 1;
+                }
+                break;
+
+            case 'g' :
+                if (!convertStringToUInt64(optarg, &match.graine)) {
+                    fprintf(stderr, "Argument incorrect : %s.\n", optarg);
+                    fprintf(stderr, "L'option -g requiert un nombre entier positif ou nul en argument.\n");
+                    return 1;
+                }
+                break;
+
+            case 'v' :
+                if (convertStringToInt(optarg, &intResult) && intResult >= 0)
+                    match.verboseLevel = intResult;
+                else {
+                    fprintf(stderr, "Argument incorrect : %s.\n", optarg);
+                    fprintf(stderr, "L'option -v requiert un nombre entier positif ou nul en argument.\n");
+                    return 1;
+                }
+                break;
+
+            case 'A' :
+                options[0] = optarg;
+                break;
+
+            case 'B' :
+                options[1] = optarg;
+                break;
+
+            case '?':
+                if (optopt == 'N' || optopt == 'j' || optopt == 'g' || optopt == 'v' || optopt == 'A' || optopt == 'B')
+                    fprintf(stderr, "Argument requis pour l'option -%c.\n", optopt);
+                else if(isprint(optopt))
+                    fprintf (stderr, "Option inconnu : `-%c'.\n", optopt);
+                else
+                    fprintf (stderr, "Option inconnu : `\\x%x'.\n", optopt);
+
+                fprintf(stderr, "Utiliser -h ou --help pour obtenir de l'aide.\n");
+                return 1;
+        }
+    }
+
+    if (printHelp) {
+        printf( "\nutilisation : Match [options] -A \"options du moteur A\" -B \"options du moteur B\""
+                "\n\noptions :"
+                "\n\n-N arg (ou --parties ou --games) : nombre de parties (100 par défaut)."
+                "\n\n-j arg (ou --jobs) : nombre de parties jouées en parallèle (nombre de processeurs par défaut)."
+                "\n\n-g arg (ou --graine ou --seed) : graine des générateurs aléatoires (tirée à partir de l'heure par défaut)."
+                "\nLa graine de chaque moteur ne dépend que de la partie : avec des limites en nombre d'itérations, le match est reproductible."
+                "\n\n-v arg (ou --verbose) : 1 pour afficher le résultat de chaque partie."
+                "\n\noptions des moteurs (mêmes options que Puissance4, 10000 itérations par défaut) :"
+                "\n-t temps, -i iterations, -o optimisation, -p threads, -s (arbre partagé), -f (feuilles),"
+                "\n-k simulations par feuille, -n noeuds max, -r (robuste) ou -m (max), -P (réflexion pendant le tour de l'autre moteur),"
+                "\n-b livre d'ouvertures, -z nombre de cases vides à partir duquel le solveur exact est utilisé (%d par défaut, 0 pour aucun),"
+                "\n-a (solveur exact pour tous les coups). Sans limite de temps, le solveur explore au plus %d positions par itération"
+                "\nde la moitié de la limite d'itérations, puis laisse la place à MCTS s'il n'a pas abouti."
+                "\nLa réflexion occupe un thread de plus par moteur et rend le match non reproductible."
+                "\n\nLe moteur A commence les parties impaires, le moteur B les parties paires."
+                "\n\n", CASES_FINALE_DEFAUT, FINALE_NOEUDS_PAR_ITERATION);
+        return 0;
+    }
+
+    for (m = 0 ; m < 2 ; m++)
+        if (!lireOptionsMoteur(options[m], m == 0 ? 'A' : 'B', &match.parametres[m], &match.reflexion[m]))
+            return 1;
+
+    match.prochainePartie = 0;
+    match.nuls = 0;
+    for (m = 0 ; m < 2 ; m++) {
+        match.victoires[m] = 0;
+        match.nb_simulations[m] = 0;
+        match.temps[m] = 0;
+        match.nb_recherches[m] = 0;
+        match.nb_coups_livre[m] = 0;
+        match.nb_coups_finale[m] = 0;
+    }
+    pthread_mutex_init(&match.verrou, NULL);
+
+    if (nbThreads > match.nbParties)
+        nbThreads = match.nbParties;
+
+    struct timespec debut, fin;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+
+    // Le thread principal joue aussi des parties
+    pthread_t * threads = (pthread_t *)malloc(nbThreads * sizeof(pthread_t));
+    int t;
+    for (t = 1 ; t < nbThreads ; t++) {
+        if (pthread_create(&threads[t], NULL, threadMatch, &match) != 0) {
+            fprintf(stderr, "Impossible de créer un thread pour le match.\n");
+            return 1;
+        }
+    }
+    threadMatch(&match);
+    for (t = 1 ; t < nbThreads ; t++)
+        pthread_join(threads[t], NULL);
+    free(threads);
+
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    double duree = (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+
+    // Score de A (victoire : 1, nul : 1/2) et son intervalle de confiance
+    int n = match.nbParties;
+    double score = (match.victoires[0] + 0.5 * match.nuls) / n;
+    double variance = ( match.victoires[0] * (1 - score) * (1 - score)
+                      + match.nuls * (0.5 - score) * (0.5 - score)
+                      + match.victoires[1] * score * score ) / n;
+    double ecart = QUANTILE_95 * sqrt(variance / n);
+
+    printf("\n%d parties en %0.2fs (%d en parallèle)\n", n, duree, nbThreads);
+    printf("\nRésultats du moteur A (%s) contre le moteur B (%s) :\n", options[0], options[1]);
+    afficheProportion("Victoires", match.victoires[0], n);
+    afficheProportion("Nuls     ", match.nuls, n);
+    afficheProportion("Défaites ", match.victoires[1], n);
+    printf("\nScore de A : %0.3f +/- %0.3f", score, ecart);
+    printf("\nDifférence Elo : %+0.0f [%+0.0f ; %+0.0f]\n",
+           differenceElo(score), differenceElo(score - ecart), differenceElo(score + ecart));
+
+    long long simulationsTotal = 0;
+    printf("\nSimulations par seconde de recherche :");
+    for (m = 0 ; m < 2 ; m++) {
+        printf("\n  Moteur %c : %0.0f (%d coups calculés", m == 0 ? 'A' : 'B',
+               match.temps[m] > 0 ? match.nb_simulations[m] / match.temps[m] : 0, match.nb_recherches[m]);
+        if (match.parametres[m].livre != NULL)
+            printf(", %d coups du livre", match.nb_coups_livre[m]);
+        if (match.parametres[m].casesFinale > 0)
+            printf(", %d coups du solveur exact", match.nb_coups_finale[m]);
+        printf(")");
+        simulationsTotal += match.nb_simulations[m];
+    }
+    printf("\n  Ensemble des parties : %0.0f\n\n", simulationsTotal / duree);
+
+    pthread_mutex_destroy(&match.verrou);
+    for (m = 0 ; m < 2 ; m++)
+        if (match.parametres[m].livre != NULL)
+            fermerLivre(match.parametres[m].livre);
+
+    return 0;
+}
@@ -1,10 +1,13 @@
 #include "mcts.h"
+#include "chrono.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <float.h>
+#include <limits.h>
 #include <math.h>
 #include <time.h>
+#include <pthread.h>
 
 // Constantes/paramètres Algo MCTS
 #define RECOMPENSE_ORDI_GAGNE 1
@@ -13,189 +16,443 @@
 
 #define CONSTANTE_C 1.4142  // ~ Racine carré de 2
 
-Noeud * nouveauNoeud (Noeud * parent, Coup * coup) {
-	Noeud * noeud = (Noeud *)malloc(sizeof(Noeud));
+// Nb de simulations en dessous duquel sqrt(log(n)) et 1/sqrt(n) sont lus dans une table
+#define TAILLE_TABLES_UCB 4096
 
-	if ( parent != NULL && coup != NULL ) {
-		noeud->etat = copieEtat ( parent->etat );
-		jouerCoup ( noeud->etat, coup );
-		noeud->coup = coup;
-		noeud->joueur = AUTRE_JOUEUR(parent->joueur);
-	}
-	else {
-		noeud->etat = NULL;
-		noeud->coup = NULL;
-		noeud->joueur = 0;
-	}
-	noeud->parent = parent;
+IndiceNoeud nouveauNoeud (Arene * arene, Etat * etat) {
+	IndiceNoeud indice = allouerElement(arene);
+	Noeud * noeud = NOEUD(arene, indice);
+
+	noeud->joueur = AUTRE_JOUEUR(etat->joueur);
 	noeud->nb_enfants = 0;
+	noeud->coups_non_developpes = testFin(etat) == NON ? masque_coups_possibles(etat) : 0;
 
 	// POUR MCTS:
 	noeud->nb_victoires = 0;
 	noeud->sommes_recompenses = 0;
 	noeud->nb_simus = 0;
 
-	return noeud;
+	noeud->perte_virtuelle = 0;
+	noeud->verrou = 0;
+	noeud->resultat_prouve = NON;   // (fixé lors de la propagation des preuves, voir propagerPreuves)
+
+	return indice;
 }
 
-Noeud * ajouterEnfant(Noeud * parent, Coup * coup) {
-	Noeud * enfant = nouveauNoeud (parent, coup) ;
-	parent->enfants[parent->nb_enfants] = enfant;
-	parent->nb_enfants++;
+IndiceNoeud ajouterEnfant(Arene * arene, IndiceNoeud parent, Coup * coup, Etat * etat) {
+	IndiceNoeud enfant = nouveauNoeud (arene, etat) ;
+	Noeud * noeudParent = NOEUD(arene, parent);
+	noeudParent->enfants[(int)noeudParent->nb_enfants] = enfant;
+	noeudParent->colonnes[(int)noeudParent->nb_enfants] = coup->colonne;
+	// l'enfant est publié après avoir été initialisé (pour les threads qui parcourent l'arbre partagé),
+	// et le coup n'est retiré des coups non développés qu'ensuite : un thread qui voit tous les coups développés
+	// (lecture acquire de coups_non_developpes) voit aussi tous les enfants
+	__atomic_store_n(&noeudParent->nb_enfants, noeudParent->nb_enfants + 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&noeudParent->coups_non_developpes, noeudParent->coups_non_developpes & ~(1u << coup->colonne), __ATOMIC_RELEASE);
 	return enfant;
 }
 
-void freeNoeud (Noeud * noeud) {
-	if (noeud->etat != NULL)
-		free(noeud->etat);
+IndiceNoeud ajouterEnfantTransposition(Arene * arene, TableTransposition * table, IndiceNoeud parent, Coup * coup, Etat * etat) {
+	// On cherche si la position obtenue est déjà dans l'arbre
+	uint64_t cle = clePosition(etat);
+	IndiceNoeud enfant = chercherPosition(table, cle);
 
-	while (noeud->nb_enfants > 0) {
-		freeNoeud(noeud->enfants[noeud->nb_enfants-1]);
-		noeud->nb_enfants --;
+	if (enfant == AUCUN_NOEUD) {
+		enfant = ajouterEnfant(arene, parent, coup, etat);
+		ajouterPosition(table, cle, enfant);
 	}
-	if (noeud->coup != NULL)
-		free(noeud->coup);
+	else {
+		// la position existe déjà : le noeud est partagé
+		Noeud * noeudParent = NOEUD(arene, parent);
+		noeudParent->enfants[(int)noeudParent->nb_enfants] = enfant;
+		noeudParent->colonnes[(int)noeudParent->nb_enfants] = coup->colonne;
+		noeudParent->coups_non_developpes &= ~(1u << coup->colonne);
+		noeudParent->nb_enfants++;
+	}
+	return enfant;
+}
+
+/** Retourne la colonne correspondant au n-ième bit à 1 (en partant de 0) du masque de coups */
+static int nieme_colonne(unsigned int coups, int n) {
+    while (n > 0) {
+        coups &= coups - 1; // on retire le bit à 1 le plus faible
+        n--;
+    }
+    return __builtin_ctz(coups);
+}
+
+/** Tables de sqrt(log(n)) et 1/sqrt(n) pour les petits nombres de simulations */
+static double tableRacineLog[TAILLE_TABLES_UCB];
+static double tableInverseRacine[TAILLE_TABLES_UCB];
+static pthread_once_t tablesUCBInitialisees = PTHREAD_ONCE_INIT;
+
+static void initTablesUCB(void) {
+    int n;
+    tableRacineLog[0] = 0;
+    tableInverseRacine[0] = 0;
+    for (n = 1 ; n < TAILLE_TABLES_UCB ; n++) {
+        tableRacineLog[n] = sqrt(log(n));
+        tableInverseRacine[n] = 1 / sqrt(n);
+    }
+}
 
-	free(noeud);
+double racineLogSimus(int nbSimus) {
+    if (nbSimus < TAILLE_TABLES_UCB)
+        return tableRacineLog[nbSimus];
+    return sqrt(log(nbSimus));
 }
 
-double calculerBValeurNoeud(Noeud * noeud) {
+double calculerBValeurNoeud(Noeud * noeud, int joueurParent, double racineLogSimusParent) {
+    // (les statistiques peuvent être modifiées en même temps par d'autres threads dans l'arbre partagé)
+    int pertesVirtuelles = __atomic_load_n(&noeud->perte_virtuelle, __ATOMIC_RELAXED);
+    int nbSimus = __atomic_load_n(&noeud->nb_simus, __ATOMIC_RELAXED) + pertesVirtuelles;
+
     // Si le noeud n'a aucune simulation, il est prioritaire
-    if (noeud->nb_simus == 0)
+    if (nbSimus == 0)
         return DBL_MAX;
 
-    double moyenneRecompense = (double)noeud->sommes_recompenses/noeud->nb_simus;
+    double sommesRecompenses;
+    __atomic_load(&noeud->sommes_recompenses, &sommesRecompenses, __ATOMIC_RELAXED);
+    // Une perte virtuelle est une défaite pour le joueur qui choisit ce noeud (l'humain si le parent est un noeud Min)
+    if (joueurParent == 1)
+        sommesRecompenses += pertesVirtuelles * RECOMPENSE_ORDI_GAGNE;
+    else
+        sommesRecompenses += pertesVirtuelles * RECOMPENSE_HUMAIN_GAGNE;
+
+    double moyenneRecompense = sommesRecompenses/nbSimus;
     // *-1 si le noeud parent est un noeud Min = si le coup joué pour arriver ici a été effectué par l'ordinateur
-    if (noeud->parent->joueur == 1)
+    if (joueurParent == 1)
         moyenneRecompense *= -1;
 
-    return moyenneRecompense + CONSTANTE_C * sqrt( log(noeud->parent->nb_simus) / noeud->nb_simus );
+    double inverseRacine = nbSimus < TAILLE_TABLES_UCB ? tableInverseRacine[nbSimus] : 1 / sqrt(nbSimus);
+    return moyenneRecompense + CONSTANTE_C * racineLogSimusParent * inverseRacine;
 }
 
-Noeud * selectionUCB(Noeud * racine) {
-    Noeud * noeudCourant = racine;
-    int i = 0;
+/** Retourne le résultat prouvé d'un noeud (NON s'il ne l'est pas) */
+static inline FinDePartie resultatProuve(Noeud * noeud) {
+    return (FinDePartie)__atomic_load_n(&noeud->resultat_prouve, __ATOMIC_RELAXED);
+}
 
-    // Si on arrive à un noeud terminal ou un dont tous les fils n'ont pas été développés
-    if (testFin(noeudCourant->etat) != NON || noeudCourant->nb_enfants != nombre_coups_possibles(noeudCourant->etat))
-        return noeudCourant;
+/** Retourne le résultat correspondant à la victoire du joueur qui doit jouer dans la position du noeud */
+static inline FinDePartie victoireJoueur(Noeud * noeud) {
+    return noeud->joueur == 1 ? HUMAIN_GAGNE : ORDI_GAGNE;
+}
 
-    // Sinon, on sélectionne le fils possédant la B-valeur maximale
-    Noeud * noeudMaxBValeur = noeudCourant->enfants[0];
-    double maxBValeur = calculerBValeurNoeud(noeudMaxBValeur);
-    for (i = 1 ; i < noeudCourant->nb_enfants ; i++) {
-        double bValeurCourante = calculerBValeurNoeud(noeudCourant->enfants[i]);
-        if (maxBValeur < bValeurCourante) {
-            noeudMaxBValeur = noeudCourant->enfants[i];
+/** Retourne le résultat correspondant à la défaite du joueur qui doit jouer dans la position du noeud */
+static inline FinDePartie defaiteJoueur(Noeud * noeud) {
+    return noeud->joueur == 1 ? ORDI_GAGNE : HUMAIN_GAGNE;
+}
+
+/** Retourne le rang parmi les fils du noeud de celui possédant la B-valeur maximale
+    (sqrt(log(N)) du noeud n'est calculé qu'une fois pour tous ses fils).
+    Un fils dont la victoire est prouvée (pour le joueur qui choisit) est choisi directement
+    et ceux dont la défaite est prouvée sont écartés : retourne -1 si tous le sont. */
+static int enfantMaxBValeur(Arene * arene, Noeud * noeud, int nbEnfants) {
+    int nbSimus = __atomic_load_n(&noeud->nb_simus, __ATOMIC_RELAXED) + __atomic_load_n(&noeud->perte_virtuelle, __ATOMIC_RELAXED);
+    double racineLog = racineLogSimus(nbSimus);
+    FinDePartie victoire = victoireJoueur(noeud), defaite = defaiteJoueur(noeud);
+
+    int rangMaxBValeur = -1;
+    double maxBValeur = 0;
+    int i;
+    for (i = 0 ; i < nbEnfants ; i++) {
+        Noeud * enfant = NOEUD(arene, noeud->enfants[i]);
+        FinDePartie resultat = resultatProuve(enfant);
+        if (resultat == victoire)
+            return i;
+        if (resultat == defaite)
+            continue;
+
+        double bValeurCourante = calculerBValeurNoeud(enfant, noeud->joueur, racineLog);
+        if (rangMaxBValeur < 0 || maxBValeur < bValeurCourante) {
+            rangMaxBValeur = i;
             maxBValeur = bValeurCourante;
         }
     }
-    // Appel récursif sur le fils possédant la B-valeur maximale
-    return selectionUCB(noeudMaxBValeur);
+    return rangMaxBValeur;
+}
+
+/** Descend dans le fils de rang donné : l'ajoute au chemin et joue le coup correspondant sur la position du chemin */
+static IndiceNoeud descendre(Noeud * noeud, int rang, Chemin * chemin) {
+    Coup coup = { noeud->colonnes[rang] };
+    jouerCoup(&chemin->etat, &coup);
+    return noeud->enfants[rang];
 }
 
-Noeud * expansionNoeud(Noeud * noeud) {
-    if (testFin(noeud->etat) != NON)    // Si le noeud représente un état final
-        return noeud;                   // on ne le développe pas
+IndiceNoeud selectionUCB(Arene * arene, IndiceNoeud racine, Etat * etatRacine, Chemin * chemin) {
+    IndiceNoeud indiceCourant = racine;
+    chemin->longueur = 0;
+    chemin->etat = *etatRacine;
+    pthread_once(&tablesUCBInitialisees, initTablesUCB);
 
-    Coup ** coups = coups_possibles(noeud->etat);
+    while (true) {
+        Noeud * noeudCourant = NOEUD(arene, indiceCourant);
+        chemin->noeuds[chemin->longueur++] = indiceCourant;
 
-    // On enlève les coups correspondant aux fils existants du noeud
-    int k = 0;
-    while (coups[k] != NULL) {
+        // Si on arrive à un noeud dont tous les fils n'ont pas été développés, à un noeud terminal (sans fils)
+        // ou à un noeud dont le résultat est prouvé
+        if (noeudCourant->coups_non_developpes != 0 || noeudCourant->nb_enfants == 0 || resultatProuve(noeudCourant) != NON)
+            return indiceCourant;
 
-        bool coupDejaDev = false;
+        // Sinon, on descend dans le fils possédant la B-valeur maximale
+        // (si tous les fils sont perdants, le noeud sera prouvé lors de la propagation)
+        int rang = enfantMaxBValeur(arene, noeudCourant, noeudCourant->nb_enfants);
+        if (rang < 0)
+            return indiceCourant;
+        indiceCourant = descendre(noeudCourant, rang, chemin);
+    }
+}
 
-        // Pour chaque fils
-        int i;
-        for (i = 0 ; i < noeud->nb_enfants ; i++) {
-            // Si il s'agit du même coup
-            if (coups[k]->colonne == noeud->enfants[i]->coup->colonne) {
-                coupDejaDev = true; // ce coup a déjà un fils correspondant
-                break;              // on arrête le parcours des fils
-            }
+IndiceNoeud expansionNoeud(Arene * arene, TableTransposition * table, Chemin * chemin, Alea * alea) {
+    IndiceNoeud indice = chemin->noeuds[chemin->longueur - 1];
+    Noeud * noeud = NOEUD(arene, indice);
+
+    unsigned int coups = noeud->coups_non_developpes;
+    if (coups == 0 || noeud->resultat_prouve != NON)    // Si le noeud représente un état final ou un résultat prouvé
+        return indice;                                  // on ne le développe pas
+
+    // On développe un fils au hasard parmi les coups qui n'en ont pas encore
+    Coup coup = { nieme_colonne(coups, aleaBorne(alea, __builtin_popcount(coups))) };
+    jouerCoup(&chemin->etat, &coup);
+
+    IndiceNoeud enfant;
+    if (table != NULL)
+        enfant = ajouterEnfantTransposition(arene, table, indice, &coup, &chemin->etat);
+    else
+        enfant = ajouterEnfant(arene, indice, &coup, &chemin->etat);
+
+    chemin->noeuds[chemin->longueur++] = enfant;
+    return enfant;
+}
+
+/** Simule une partie comme simulerPartie et ajoute à nbCoups le nb de coups joués */
+static inline FinDePartie simulerPartieCompteur(Etat * etatDepart, PolitiqueSimulation politique, Alea * alea, long long * nbCoups) {
+    // La simulation se fait sur une copie locale : aucune allocation pendant la partie
+    Etat etat = *etatDepart;
+
+    // Tant que la partie n'est pas terminée
+    while (testFin(&etat) == NON) {
+        Coup coupAJoue = { -1 };
+
+        // Coup gagnant (pour l'ordinateur seulement avec COUP_GAGNANT), sinon coup gagnant de l'adversaire à bloquer (avec MENACES)
+        // (la case la plus basse de chaque colonne jouable est comparée aux menaces de chaque joueur)
+        if (politique == MENACES || (politique == COUP_GAGNANT && etat.joueur == 1)) {
+            Bitboard jouables = casesJouables(etat.masque);
+            Bitboard cases = casesGagnantes(etat.pions[etat.joueur], etat.masque) & jouables;
+            if (cases == 0 && politique == MENACES)
+                cases = casesGagnantes(etat.pions[AUTRE_JOUEUR(etat.joueur)], etat.masque) & jouables;
+            if (cases != 0)
+                coupAJoue.colonne = PREMIER_BIT(cases) / HAUTEUR_COLONNE;   // (celui de la première colonne)
         }
 
-        if (coupDejaDev) {  // si ce coup a déjà un fils correspondant
-            // On supprime ce coup et on décale la liste de coups
-            free(coups[k]);
-            int j = k;
-            while (coups[j] != NULL) {
-                coups[j] = coups[j+1];
-                j++;
-            }
+        // Si aucun coup n'a été choisi, on joue un coup aléatoirement
+        if (coupAJoue.colonne < 0) {
+            unsigned int coups = masque_coups_possibles(&etat);
+            coupAJoue.colonne = nieme_colonne(coups, aleaBorne(alea, __builtin_popcount(coups)));
         }
-        else
-            k++;
 
+        jouerCoup(&etat, &coupAJoue);  // On joue le coup
     }
 
-    // On développe un fils au hasard
-    int choix = rand() % k;
+    *nbCoups += etat.nb_coups - etatDepart->nb_coups;
+    return testFin(&etat);
+}
+
+FinDePartie simulerPartie(Etat * etatDepart, PolitiqueSimulation politique, Alea * alea) {
+    long long nbCoups = 0;
+    return simulerPartieCompteur(etatDepart, politique, alea, &nbCoups);
+}
+
+#if BITS_BITBOARD == 64
+// (les lots ne sont pas disponibles pour les plateaux de 128 bits : pas de vecteurs d'entiers de 128 bits)
+
+/** Bitboards des parties d'un lot (une partie par composante, opérations réalisées sur toutes les parties à la fois) */
+typedef Bitboard LotBitboards __attribute__((vector_size(LOT_SIMULATIONS * sizeof(Bitboard))));
+
+// Masque (toutes composantes à 1) des composantes non nulles d'un vecteur (sans comparaison, vectorisée par tous les jeux d'instructions)
+#define LOT_NON_NUL(v) (-(((v) | -(v)) >> 63))
 
-    // On libère la mémoire des coups inutilisés
-    k = 0;
-    while (coups[k] != NULL) {
-        if (k != choix)
-            free(coups[k]); // sauf celle du coup joué qui sera libérée dans freenoeud
-        k++;
+/** Range dans cases les cases de chaque partie ayant, dans la direction de décalage s, i pions alignés avant elles
+    et LONGUEUR_ALIGNEMENT-1-i après (voir casesGagnantesDirection)
+    (les vecteurs sont passés par adresse : l'ABI ne permet pas toujours de les passer dans des registres) */
+static inline __attribute__((always_inline)) void casesGagnantesDirectionLot(LotBitboards * cases, const LotBitboards * lotPions, int s) {
+    LotBitboards pions = *lotPions;
+    LotBitboards r = { 0 };
+    int i, j, m;
+    for (i = 0 ; i < LONGUEUR_ALIGNEMENT ; i += 2) {
+        j = i < LONGUEUR_ALIGNEMENT - 1 ? i : LONGUEUR_ALIGNEMENT - 2;
+        LotBitboards couple = (pions << ((j + 1) * s)) | (pions >> ((LONGUEUR_ALIGNEMENT - 1 - j) * s));
+        for (m = 1 ; m <= j ; m++)
+            couple &= pions << (m * s);
+        for (m = 1 ; m < LONGUEUR_ALIGNEMENT - 1 - j ; m++)
+            couple &= pions >> (m * s);
+        r |= couple;
     }
+    *cases = r;
+}
 
-    Noeud * enfant = ajouterEnfant(noeud, coups[choix]);
-    free(coups);    // On libère la mémoire de la liste de coups
-    return enfant;
+/** Range dans cases les cases vides qui compléteraient un alignement avec les pions de chaque partie (voir casesGagnantes) */
+static inline __attribute__((always_inline)) void casesGagnantesLot(LotBitboards * cases, const LotBitboards * lotPions, const LotBitboards * masque) {
+    LotBitboards pions = *lotPions, direction;
+    int i;
+
+    // verticale
+    LotBitboards r = pions << 1;
+    for (i = 2 ; i < LONGUEUR_ALIGNEMENT ; i++)
+        r &= pions << i;
+
+    // horizontale et diagonales
+    casesGagnantesDirectionLot(&direction, &pions, HAUTEUR_COLONNE);
+    r |= direction;
+    casesGagnantesDirectionLot(&direction, &pions, HAUTEUR_COLONNE - 1);
+    r |= direction;
+    casesGagnantesDirectionLot(&direction, &pions, HAUTEUR_COLONNE + 1);
+    r |= direction;
+
+    *cases = r & (MASQUE_PLATEAU ^ *masque);
 }
 
-FinDePartie simulerPartie(Etat * etat, bool choisirCoupGagnant) {
-    FinDePartie resultatFinDePartie;
-    // Tant que la partie n'est pas terminée
-    while ((resultatFinDePartie = testFin(etat)) == NON) {
-        Coup** coups = coups_possibles(etat);
-        Coup* coupAJoue = NULL;
+/** Range dans alignes le masque (toutes composantes à 1) des parties où les pions forment un alignement (voir debutsAlignements) */
+static inline __attribute__((always_inline)) void alignementLot(LotBitboards * alignes, const LotBitboards * lotPions) {
+    LotBitboards pions = *lotPions;
+    static const int decalages[4] = { 1, HAUTEUR_COLONNE, HAUTEUR_COLONNE - 1, HAUTEUR_COLONNE + 1 };
+    LotBitboards alignements = { 0 };
+    int d;
+    for (d = 0 ; d < 4 ; d++) {
+        LotBitboards suites = pions;
+        int longueur = 1;
+        while (2 * longueur <= LONGUEUR_ALIGNEMENT) {
+            suites &= suites >> (longueur * decalages[d]);
+            longueur *= 2;
+        }
+        if (longueur < LONGUEUR_ALIGNEMENT)
+            suites &= suites >> ((LONGUEUR_ALIGNEMENT - longueur) * decalages[d]);
+        alignements |= suites;
+    }
+    *alignes = LOT_NON_NUL(alignements);
+}
 
-        // Si on doit choisir un coup gagnant quand cela est possible (si c'est le tour de l'ordinateur)
-        if (choisirCoupGagnant && etat->joueur == 1) {
-            int k = 0;
-            // On teste tous les coups pour voir si un des coups est gagnant
-            while (coups[k] != NULL && coupAJoue == NULL) {
-                Etat * etatATester = copieEtat(etat);
-                jouerCoup(etatATester, coups[k]);
+/** Retourne la somme des composantes */
+static inline __attribute__((always_inline)) uint64_t sommeLot(const LotBitboards * v) {
+    uint64_t somme = 0;
+    int l;
+    for (l = 0 ; l < LOT_SIMULATIONS ; l++)
+        somme += (*v)[l];
+    return somme;
+}
 
-                if (testFin(etatATester) == ORDI_GAGNE)
-                    coupAJoue = coups[k];
+/** Simule au pas nbSimulations parties (au plus LOT_SIMULATIONS) à partir d'un état non final
+    et ajoute leurs résultats à ceux passés en paramètre.
+    Chaque partie tire ses coups avec son propre générateur xorshift, initialisé avec alea. */
+static void simulerLot(Etat * etatDepart, int nbSimulations, PolitiqueSimulation politique, Alea * alea, ResultatsSimulations * resultats) {
+    LotBitboards courant, masque, actif, graine;    // pions du joueur qui doit jouer et cases occupées de chaque partie
+    LotBitboards victoires = { 0 }, defaites = { 0 }, nuls = { 0 }, coups = { 0 };
+    int l, c;
 
-                free(etatATester);
+    for (l = 0 ; l < LOT_SIMULATIONS ; l++) {
+        courant[l] = etatDepart->pions[etatDepart->joueur];
+        masque[l] = etatDepart->masque;
+        actif[l] = l < nbSimulations ? ~(Bitboard)0 : 0;
+        graine[l] = alea64(alea) | 1;   // (l'état d'un générateur xorshift ne doit pas être nul)
+    }
 
-                k++;
-            }
-            // Si aucun coup gagnant n'est possible
-            if (coupAJoue == NULL)
-                coupAJoue = coups[rand() % k];  // On joue un coup aléatoirement
+    // toutes les parties avancent d'un coup à chaque tour : le joueur qui doit jouer est le même dans toutes
+    int joueur = etatDepart->joueur;
+    do {
+        LotBitboards jouables = (masque + MASQUE_BAS) & MASQUE_PLATEAU;
+
+        // Tirage d'un coup au hasard parmi les colonnes jouables (sans branchement : toutes les colonnes sont parcourues)
+        LotBitboards nbJouables = { 0 };
+        for (c = 0 ; c < NB_COLONNES ; c++)
+            nbJouables += LOT_NON_NUL(jouables & MASQUE_COLONNE(c)) & 1;
+        graine ^= graine << 13;
+        graine ^= graine >> 7;
+        graine ^= graine << 17;
+        LotBitboards rang = ((graine >> 32) * nbJouables) >> 32;
+        LotBitboards coup = { 0 };
+        for (c = 0 ; c < NB_COLONNES ; c++) {
+            LotBitboards caseColonne = jouables & MASQUE_COLONNE(c);
+            coup |= caseColonne & ~LOT_NON_NUL(rang);
+            rang -= LOT_NON_NUL(caseColonne) & 1;   // (devient non nul une fois le coup choisi)
         }
-        // Sinon, on choisit le coup aléatoirement
-        else {
-            int k = 0;
-            while (coups[k] != NULL)    k++;
-            coupAJoue = coups[rand() % k];  // On joue un coup aléatoirement
+
+        // Coup gagnant (pour l'ordinateur seulement avec COUP_GAGNANT), sinon coup gagnant de l'adversaire à bloquer (avec MENACES),
+        // joué à la place du coup tiré (celui de la première colonne)
+        if (politique == MENACES || (politique == COUP_GAGNANT && joueur == 1)) {
+            LotBitboards cases;
+            casesGagnantesLot(&cases, &courant, &masque);
+            cases &= jouables;
+            if (politique == MENACES) {
+                LotBitboards adversaire = courant ^ masque, blocages;
+                casesGagnantesLot(&blocages, &adversaire, &masque);
+                cases |= blocages & jouables & ~LOT_NON_NUL(cases);
+            }
+            cases &= -cases;
+            coup = cases | (coup & ~LOT_NON_NUL(cases));
         }
 
-        jouerCoup(etat, coupAJoue);  // On joue le coup
+        // Les parties terminées ne jouent plus
+        coup &= actif;
+        coups += actif & 1;
+        courant |= coup;
+        masque |= coup;
 
-        // On libère la mémoire
-        int k = 0;
-        while (coups[k] != NULL) {
-            free(coups[k]);
-            k++;
-        }
-        free(coups);
+        LotBitboards gagne;
+        alignementLot(&gagne, &courant);
+        gagne &= actif;
+        LotBitboards plein = ~LOT_NON_NUL(masque ^ MASQUE_PLATEAU) & actif & ~gagne;
+        if (joueur == 1)
+            victoires += gagne & 1;
+        else
+            defaites += gagne & 1;
+        nuls += plein & 1;
+        actif &= ~(gagne | plein);
+
+        courant ^= masque;  // pions de l'autre joueur
+        joueur = AUTRE_JOUEUR(joueur);
+    } while (sommeLot(&actif) != 0);
+
+    resultats->nb_victoires += sommeLot(&victoires);
+    resultats->nb_defaites += sommeLot(&defaites);
+    resultats->nb_nuls += sommeLot(&nuls);
+    resultats->nb_coups += sommeLot(&coups);
+}
+#endif
+
+void simulerParties(Etat * etat, int nbSimulations, PolitiqueSimulation politique, Alea * alea, ResultatsSimulations * resultats) {
+#if BITS_BITBOARD == 64
+    // Plusieurs parties à partir d'une position non finale : simulées par lots
+    if (nbSimulations > 1 && testFin(etat) == NON) {
+        int k;
+        for (k = 0 ; k < nbSimulations ; k += LOT_SIMULATIONS)
+            simulerLot(etat, nbSimulations - k < LOT_SIMULATIONS ? nbSimulations - k : LOT_SIMULATIONS, politique, alea, resultats);
+        return;
     }
+#endif
 
-    return resultatFinDePartie;
+    int k;
+    for (k = 0 ; k < nbSimulations ; k++) {
+        switch(simulerPartieCompteur(etat, politique, alea, &resultats->nb_coups)) {
+            case ORDI_GAGNE :
+                resultats->nb_victoires++;
+                break;
+            case HUMAIN_GAGNE :
+                resultats->nb_defaites++;
+                break;
+            case MATCHNUL :
+                resultats->nb_nuls++;
+                break;
+            default:
+                break;
+        }
+    }
 }
 
-void propagerResultat(Noeud * noeud, FinDePartie resultat) {
+void propagerResultat(Arene * arene, Chemin * chemin, FinDePartie resultat) {
 
-    while (noeud != NULL) {
+    int k;
+    for (k = chemin->longueur - 1 ; k >= 0 ; k--) {
+        Noeud * noeud = NOEUD(arene, chemin->noeuds[k]);
         noeud->nb_simus++;
         switch(resultat) {
             case ORDI_GAGNE :
@@ -211,125 +468,1041 @@ void propagerResultat(Noeud * noeud, FinDePartie resultat) {
             default:
                 break;
         }
-        noeud = noeud->parent;
     }
 
 }
 
-Noeud * trouverNoeudMeilleurCoup(Noeud * racine, MethodeChoixCoup methode) {
+void propagerResultats(Arene * arene, Chemin * chemin, ResultatsSimulations * resultats) {
+    int nbSimus = resultats->nb_victoires + resultats->nb_nuls + resultats->nb_defaites;
+    double recompenses = resultats->nb_victoires * RECOMPENSE_ORDI_GAGNE
+                       + resultats->nb_nuls * RECOMPENSE_MATCHNUL
+                       + resultats->nb_defaites * RECOMPENSE_HUMAIN_GAGNE;
 
-    Noeud * noeudMeilleurCoup = racine->enfants[0];
-    int i = 1, maxSimus;
-    double maxValeurs, valeurCourante;
+    int k;
+    for (k = chemin->longueur - 1 ; k >= 0 ; k--) {
+        Noeud * noeud = NOEUD(arene, chemin->noeuds[k]);
+        noeud->nb_simus += nbSimus;
+        noeud->nb_victoires += resultats->nb_victoires;
+        noeud->sommes_recompenses += recompenses;
+    }
+}
 
-    switch(methode) {   // max simulations
-        case ROBUSTE :
-            maxSimus = noeudMeilleurCoup->nb_simus;
+/** Retourne le résultat du noeud s'il est prouvé par ceux de ses fils (NON sinon) et le conserve :
+    victoire si l'un des fils est gagnant pour le joueur qui doit jouer,
+    sinon nul ou défaite lorsque tous les coups ont été développés et que leurs résultats sont prouvés */
+static FinDePartie resoudreNoeud(Arene * arene, Noeud * noeud) {
+    FinDePartie resultat = resultatProuve(noeud);
+    if (resultat != NON)
+        return resultat;
 
-            for (i = 1 ; i < racine->nb_enfants ; i++) {
-                if (maxSimus < racine->enfants[i]->nb_simus) {
-                    noeudMeilleurCoup = racine->enfants[i];
-                    maxSimus = noeudMeilleurCoup->nb_simus;
-                }
-            }
+    FinDePartie victoire = victoireJoueur(noeud);
+    // (coups_non_developpes est lu avant nb_enfants : voir ajouterEnfant)
+    bool tousProuves = __atomic_load_n(&noeud->coups_non_developpes, __ATOMIC_ACQUIRE) == 0;
+    bool nul = false;
+    int nbEnfants = __atomic_load_n(&noeud->nb_enfants, __ATOMIC_ACQUIRE);
+    int i;
+    for (i = 0 ; i < nbEnfants ; i++) {
+        FinDePartie resultatEnfant = resultatProuve(NOEUD(arene, noeud->enfants[i]));
+        if (resultatEnfant == victoire) {
+            resultat = victoire;
             break;
+        }
+        if (resultatEnfant == NON)
+            tousProuves = false;
+        else if (resultatEnfant == MATCHNUL)
+            nul = true;
+    }
+    if (resultat == NON && tousProuves)
+        resultat = nul ? MATCHNUL : defaiteJoueur(noeud);
 
-        case MAX :      // max valeurs
-            if (noeudMeilleurCoup->nb_simus == 0)
-                maxValeurs = 0;
-            else
-                maxValeurs = (double)noeudMeilleurCoup->sommes_recompenses / noeudMeilleurCoup->nb_simus;
+    if (resultat != NON)
+        __atomic_store_n(&noeud->resultat_prouve, (char)resultat, __ATOMIC_RELAXED);
+    return resultat;
+}
+
+void propagerPreuves(Arene * arene, Chemin * chemin) {
+    // Le dernier noeud du chemin est prouvé s'il représente un état final
+    Noeud * feuille = NOEUD(arene, chemin->noeuds[chemin->longueur - 1]);
+    if (testFin(&chemin->etat) != NON)
+        __atomic_store_n(&feuille->resultat_prouve, (char)testFin(&chemin->etat), __ATOMIC_RELAXED);
+
+    // On remonte tant que les noeuds sont prouvés
+    // (un noeud partagé par plusieurs parents est pris en compte dans les autres lorsqu'ils sont parcourus)
+    int k;
+    for (k = chemin->longueur - 1 ; k >= 0 ; k--)
+        if (resoudreNoeud(arene, NOEUD(arene, chemin->noeuds[k])) == NON)
+            break;
+}
+
+IndiceNoeud trouverNoeudMeilleurCoup(Arene * arene, IndiceNoeud indiceRacine, MethodeChoixCoup methode) {
+
+    Noeud * racine = NOEUD(arene, indiceRacine);
+    FinDePartie victoire = victoireJoueur(racine), defaite = defaiteJoueur(racine);
+    int i;
+
+    // Un coup dont la victoire est prouvée est joué directement
+    // et ceux dont la défaite est prouvée sont écartés (sauf s'ils le sont tous)
+    bool ecarterDefaites = false;
+    for (i = 0 ; i < racine->nb_enfants ; i++) {
+        FinDePartie resultat = resultatProuve(NOEUD(arene, racine->enfants[i]));
+        if (resultat == victoire)
+            return racine->enfants[i];
+        if (resultat != defaite)
+            ecarterDefaites = true;
+    }
+
+    IndiceNoeud noeudMeilleurCoup = AUCUN_NOEUD;
+    double maxValeurs = 0, valeurCourante = 0;
+
+    for (i = 0 ; i < racine->nb_enfants ; i++) {
+        Noeud * enfant = NOEUD(arene, racine->enfants[i]);
+        if (ecarterDefaites && resultatProuve(enfant) == defaite)
+            continue;
+
+        switch(methode) {
+            case ROBUSTE :  // max simulations
+                valeurCourante = enfant->nb_simus;
+                break;
 
-            for (i = 1 ; i < racine->nb_enfants ; i++) {
-                if (racine->enfants[i]->nb_simus == 0)
+            case MAX :      // max valeurs
+                if (enfant->nb_simus == 0)
                     valeurCourante = 0;
                 else
-                    valeurCourante = (double)racine->enfants[i]->sommes_recompenses / racine->enfants[i]->nb_simus;
+                    valeurCourante = (double)enfant->sommes_recompenses / enfant->nb_simus;
+                break;
+        }
 
-                if (maxValeurs < valeurCourante) {
-                    noeudMeilleurCoup = racine->enfants[i];
-                    maxValeurs = valeurCourante;
-                }
-            }
-            break;
+        if (noeudMeilleurCoup == AUCUN_NOEUD || maxValeurs < valeurCourante) {
+            noeudMeilleurCoup = racine->enfants[i];
+            maxValeurs = valeurCourante;
+        }
     }
 
     return noeudMeilleurCoup;
 }
 
-void ordijoue_mcts(Etat * etat, double tempsmax, int iterationsmax, MethodeChoixCoup methodeChoix, int optimisationLevel, int verboseLevel) {
+IndiceNoeud selectionUCBPartagee(Arene * arene, IndiceNoeud racine, Etat * etatRacine, Chemin * chemin) {
+    IndiceNoeud indiceCourant = racine;
+    chemin->longueur = 0;
+    chemin->etat = *etatRacine;
+    pthread_once(&tablesUCBInitialisees, initTablesUCB);
+
+    while (true) {
+        Noeud * noeudCourant = NOEUD(arene, indiceCourant);
+        __atomic_fetch_add(&noeudCourant->perte_virtuelle, 1, __ATOMIC_RELAXED);
+        chemin->noeuds[chemin->longueur++] = indiceCourant;
+
+        // Si on arrive à un noeud dont tous les fils n'ont pas été développés, à un noeud terminal (sans fils)
+        // ou à un noeud dont le résultat est prouvé
+        unsigned int coups = __atomic_load_n(&noeudCourant->coups_non_developpes, __ATOMIC_ACQUIRE);
+        int nbEnfants = __atomic_load_n(&noeudCourant->nb_enfants, __ATOMIC_ACQUIRE);
+        if (coups != 0 || nbEnfants == 0 || resultatProuve(noeudCourant) != NON)
+            return indiceCourant;
+
+        // Sinon, on descend dans le fils possédant la B-valeur maximale
+        int rang = enfantMaxBValeur(arene, noeudCourant, nbEnfants);
+        if (rang < 0)
+            return indiceCourant;
+        indiceCourant = descendre(noeudCourant, rang, chemin);
+    }
+}
+
+IndiceNoeud expansionNoeudPartagee(Arene * arene, Chemin * chemin, Alea * alea) {
+    IndiceNoeud indice = chemin->noeuds[chemin->longueur - 1];
+    Noeud * noeud = NOEUD(arene, indice);
+
+    if (__atomic_load_n(&noeud->coups_non_developpes, __ATOMIC_RELAXED) == 0 || resultatProuve(noeud) != NON)
+        return indice;                  // état final, résultat prouvé ou fils déjà tous développés : rien à développer
+
+    while (__atomic_test_and_set(&noeud->verrou, __ATOMIC_ACQUIRE))
+        ;
+
+    unsigned int coups = noeud->coups_non_developpes;
+
+    // Tous les fils ont pu être développés par d'autres threads depuis la sélection :
+    // la simulation est alors faite à partir du noeud lui-même
+    IndiceNoeud enfant = indice;
+    if (coups != 0) {
+        // On développe un fils au hasard
+        Coup coup = { nieme_colonne(coups, aleaBorne(alea, __builtin_popcount(coups))) };
+        jouerCoup(&chemin->etat, &coup);
+        enfant = ajouterEnfant(arene, indice, &coup, &chemin->etat);
+        __atomic_fetch_add(&NOEUD(arene, enfant)->perte_virtuelle, 1, __ATOMIC_RELAXED);
+        chemin->noeuds[chemin->longueur++] = enfant;
+    }
+
+    __atomic_clear(&noeud->verrou, __ATOMIC_RELEASE);
+    return enfant;
+}
+
+/** Ajoute valeur à somme de manière atomique */
+static void ajouterAtomique(double * somme, double valeur) {
+    double ancienne, nouvelle;
+    __atomic_load(somme, &ancienne, __ATOMIC_RELAXED);
+    do {
+        nouvelle = ancienne + valeur;
+    } while (!__atomic_compare_exchange(somme, &ancienne, &nouvelle, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+void propagerResultatsPartage(Arene * arene, Chemin * chemin, ResultatsSimulations * resultats) {
+    int nbSimus = resultats->nb_victoires + resultats->nb_nuls + resultats->nb_defaites;
+    double recompenses = resultats->nb_victoires * RECOMPENSE_ORDI_GAGNE
+                       + resultats->nb_nuls * RECOMPENSE_MATCHNUL
+                       + resultats->nb_defaites * RECOMPENSE_HUMAIN_GAGNE;
+
+    int k;
+    for (k = chemin->longueur - 1 ; k >= 0 ; k--) {
+        Noeud * noeud = NOEUD(arene, chemin->noeuds[k]);
+        __atomic_fetch_add(&noeud->nb_simus, nbSimus, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&noeud->nb_victoires, resultats->nb_victoires, __ATOMIC_RELAXED);
+        ajouterAtomique(&noeud->sommes_recompenses, recompenses);
+        __atomic_fetch_sub(&noeud->perte_virtuelle, 1, __ATOMIC_RELAXED);
+    }
+
+}
+
+/** Retourne vrai si les deux états représentent la même position */
+static bool memeEtat(Etat * a, Etat * b) {
+    return a->joueur == b->joueur && a->pions[0] == b->pions[0] && a->pions[1] == b->pions[1];
+}
+
+/** Recopie récursivement le sous-arbre d'un noeud (de position etat) de l'arène src dans l'arène dest
+    et retourne l'indice de la copie
+    (la table associe les positions déjà recopiées à leur copie : un noeud partagé n'est recopié qu'une fois) */
+static IndiceNoeud copierSousArbre(Arene * dest, TableTransposition * table, Arene * src, IndiceNoeud indice, Etat * etat) {
+    Noeud * original = NOEUD(src, indice);
+    IndiceNoeud copie;
+
+    // avec la table de transposition, un noeud atteint par plusieurs chemins n'est recopié qu'une fois
+    if (table != NULL) {
+        uint64_t cle = clePosition(etat);
+        copie = chercherPosition(table, cle);
+        if (copie != AUCUN_NOEUD)
+            return copie;
+        copie = allouerElement(dest);
+        ajouterPosition(table, cle, copie);
+    }
+    else
+        copie = allouerElement(dest);
+    Noeud * noeud = NOEUD(dest, copie);
+
+    *noeud = *original;
+
+    int i;
+    for (i = 0 ; i < noeud->nb_enfants ; i++) {
+        Etat etatEnfant = *etat;
+        Coup coup = { noeud->colonnes[i] };
+        jouerCoup(&etatEnfant, &coup);
+        noeud->enfants[i] = copierSousArbre(dest, table, src, noeud->enfants[i], &etatEnfant);
+    }
+
+    return copie;
+}
+
+IndiceNoeud reprendreArbre(ArbreRecherche * arbre, Etat * etat) {
+
+    if (arbre->arene == NULL) {
+        arbre->arene = nouvelleArene(sizeof(Noeud));
+        arbre->areneCompactage = nouvelleArene(sizeof(Noeud));
+        arbre->table = nouvelleTable();
+        arbre->racine = AUCUN_NOEUD;
+    }
+
+    // On cherche le noeud correspondant à l'état parmi la racine conservée et ses fils
+    IndiceNoeud noeudConserve = AUCUN_NOEUD;
+    if (arbre->racine != AUCUN_NOEUD) {
+        Noeud * racine = NOEUD(arbre->arene, arbre->racine);
+        if (memeEtat(&arbre->etatRacine, etat))
+            noeudConserve = arbre->racine;
+        else {
+            int i;
+            for (i = 0 ; i < racine->nb_enfants ; i++) {
+                Etat etatEnfant = arbre->etatRacine;
+                Coup coup = { racine->colonnes[i] };
+                jouerCoup(&etatEnfant, &coup);
+                if (memeEtat(&etatEnfant, etat))
+                    noeudConserve = racine->enfants[i];
+            }
+        }
+    }
+
+    if (noeudConserve == AUCUN_NOEUD) {
+        // Aucun noeud ne correspond : on repart d'un arbre vide
+        viderArene(arbre->arene);
+        viderTable(arbre->table);
+        arbre->racine = nouveauNoeud(arbre->arene, etat);
+        ajouterPosition(arbre->table, clePosition(etat), arbre->racine);
+    }
+    else if (noeudConserve != arbre->racine) {
+        // On recopie le sous-arbre conservé dans l'arène de réserve puis on libère l'ancienne arène
+        Arene * areneConservee = arbre->areneCompactage;
+        viderArene(areneConservee);
+        viderTable(arbre->table);
+        arbre->racine = copierSousArbre(areneConservee, arbre->transposition ? arbre->table : NULL, arbre->arene, noeudConserve, etat);
+        viderArene(arbre->arene);
+
+        arbre->areneCompactage = arbre->arene;
+        arbre->arene = areneConservee;
+    }
+    arbre->etatRacine = *etat;
+
+    return arbre->racine;
+}
+
+/** Libère les arbres de recherche du moteur (qui repartira d'arbres vides) */
+static void libererArbres(MoteurMCTS * moteur) {
+    arreterReflexion(moteur);
+
+    int t;
+    for (t = 0 ; t < NB_THREADS_MAX ; t++) {
+        if (moteur->arbres[t].arene != NULL) {
+            freeArene(moteur->arbres[t].arene);
+            freeArene(moteur->arbres[t].areneCompactage);
+            freeTable(moteur->arbres[t].table);
+        }
+        moteur->arbres[t].arene = NULL;
+        moteur->arbres[t].areneCompactage = NULL;
+        moteur->arbres[t].table = NULL;
+        moteur->arbres[t].racine = AUCUN_NOEUD;
+    }
+}
+
+MoteurMCTS * nouveauMoteur(void) {
+    MoteurMCTS * moteur = (MoteurMCTS *)malloc(sizeof(MoteurMCTS));
+
+    int t;
+    for (t = 0 ; t < NB_THREADS_MAX ; t++)
+        moteur->arbres[t].arene = NULL;
+    moteur->reflexion = false;
+    libererArbres(moteur);
+
+    moteur->nb_recherches = 0;
+    moteur->nb_iterations = 0;
+    moteur->nb_simulations = 0;
+    moteur->temps = 0;
+    moteur->nb_coups_livre = 0;
+    moteur->nb_coups_finale = 0;
+    moteur->finale = NULL;
+    moteur->nb_iterations_reflexion = 0;
+    for (t = 0 ; t < LARGEUR_MAX ; t++) {
+        moteur->simus_coups[t] = 0;
+        moteur->victoires_coups[t] = 0;
+    }
+
+    return moteur;
+}
+
+void freeMoteur(MoteurMCTS * moteur) {
+    libererArbres(moteur);
+    if (moteur->finale != NULL)
+        freeSolveur(moteur->finale);
+    free(moteur);
+}
+
+/** Moteur de l'ordinateur pour ordijoue_mcts (ses arbres sont créés lors du premier coup) */
+static MoteurMCTS moteurOrdi;
+
+void libererArbreMCTS(void) {
+    libererArbres(&moteurOrdi);
+    if (moteurOrdi.finale != NULL) {
+        freeSolveur(moteurOrdi.finale);
+        moteurOrdi.finale = NULL;
+    }
+}
+
+int noeudsPourMemoire(double octets) {
+    // un noeud dans l'arène de l'arbre et sa copie dans l'arène de réserve,
+    // et jusqu'à 4 entrées de table par position (la table est agrandie lorsqu'elle est à moitié pleine)
+    double noeuds = octets / (2 * sizeof(Noeud) + 4 * sizeof(EntreeTransposition));
+    return noeuds < INT_MAX ? (int)noeuds : INT_MAX;
+}
+
+/** Retourne le fils de la racine correspondant au coup joué en colonne
+    (AUCUN_NOEUD s'il n'existe pas) */
+static IndiceNoeud enfantColonne(Arene * arene, IndiceNoeud racine, int colonne) {
+    Noeud * noeud = NOEUD(arene, racine);
+    int i;
+    for (i = 0 ; i < noeud->nb_enfants ; i++)
+        if (noeud->colonnes[i] == colonne)
+            return noeud->enfants[i];
+    return AUCUN_NOEUD;
+}
+
+/** Retourne la colonne du coup menant de la racine à son fils enfant */
+static int colonneEnfant(Arene * arene, IndiceNoeud racine, IndiceNoeud enfant) {
+    Noeud * noeud = NOEUD(arene, racine);
+    int i;
+    for (i = 0 ; i < noeud->nb_enfants ; i++)
+        if (noeud->enfants[i] == enfant)
+            return noeud->colonnes[i];
+    return -1;
+}
+
+/** Lot de simulations d'une feuille réparti entre plusieurs threads (parallélisation FEUILLES) */
+typedef struct {
+
+	pthread_barrier_t debutLot;     // les threads attendent qu'un lot soit prêt
+	pthread_barrier_t finLot;       // le thread qui développe l'arbre attend la fin des simulations
+	int nbThreads;
+
+	Etat * etat;                    // état à partir duquel simuler
+	int nbSimulations;              // nb de simulations du lot
+	PolitiqueSimulation politique;
+	bool termine;                   // vrai lorsque la recherche est terminée
+
+	ResultatsSimulations resultats[NB_THREADS_MAX];     // résultats de chaque thread
+	Alea alea[NB_THREADS_MAX];                          // générateur aléatoire de chaque thread
+
+} LotSimulations;
+
+/** Réalise la part du lot de simulations revenant au thread numéro t */
+static void simulerPartLot(LotSimulations * lot, int t) {
+    int nbSimulations = lot->nbSimulations / lot->nbThreads + (t < lot->nbSimulations % lot->nbThreads);
+    ResultatsSimulations resultats = { 0, 0, 0, 0 };
+    simulerParties(lot->etat, nbSimulations, lot->politique, &lot->alea[t], &resultats);
+    lot->resultats[t] = resultats;
+}
+
+/** Paramètres d'un thread de simulation (parallélisation FEUILLES) */
+typedef struct {
+
+	LotSimulations * lot;
+	int t;  // numéro du thread
+
+} ThreadSimulation;
+
+/** Boucle d'un thread de simulation : réalise sa part de chaque lot jusqu'à la fin de la recherche */
+static void * threadSimulation(void * arg) {
+    ThreadSimulation * thread = (ThreadSimulation *)arg;
+    LotSimulations * lot = thread->lot;
+
+    while (true) {
+        pthread_barrier_wait(&lot->debutLot);
+        if (lot->termine)
+            return NULL;
+        simulerPartLot(lot, thread->t);
+        pthread_barrier_wait(&lot->finLot);
+    }
+}
+
+/** Paramètres et résultat de la recherche réalisée par un thread */
+typedef struct {
+
+	ArbreRecherche * arbre;     // arbre développé par le thread (éventuellement partagé avec les autres threads)
+	bool arbrePartage;
+	LotSimulations * lot;       // lot réparti entre les threads de simulation (NULL si les simulations sont faites par ce thread)
+	BudgetTemps * budget;       // budget de temps de la recherche (commun à tous les threads)
+	int iterationsmax;
+	int optimisationLevel;
+	bool solveur;               // propagation des résultats prouvés (niveau d'optimisation 3)
+	int simulationsParFeuille;
+	uint32_t noeudsmax;         // nb de noeuds de l'arène au-delà duquel plus aucun noeud n'est développé
+	Alea alea;                  // générateur aléatoire propre au thread
+
+	int iter;       // nb d'itérations réalisées
+	long long simulations;  // nb de simulations réellement réalisées (aucune à partir d'un noeud prouvé)
+	int refus;      // nb d'itérations sans expansion faute de mémoire
+	double temps;   // temps utilisé
+	StatistiquesRecherche * statistiques;   // statistiques relevées par le thread (NULL si elles ne sont pas exportées)
+
+} RechercheThread;
+
+/** Simule les parties à partir d'un noeud développé, seul ou avec les threads de simulation */
+static void simulerFeuille(RechercheThread * recherche, Etat * etat, PolitiqueSimulation politique, ResultatsSimulations * resultats) {
+    LotSimulations * lot = recherche->lot;
+
+    if (lot == NULL) {
+        simulerParties(etat, recherche->simulationsParFeuille, politique, &recherche->alea, resultats);
+        return;
+    }
+
+    lot->etat = etat;
+    lot->nbSimulations = recherche->simulationsParFeuille;
+    lot->politique = politique;
+    pthread_barrier_wait(&lot->debutLot);
+    simulerPartLot(lot, 0);
+    pthread_barrier_wait(&lot->finLot);
+
+    int t;
+    for (t = 0 ; t < lot->nbThreads ; t++) {
+        resultats->nb_victoires += lot->resultats[t].nb_victoires;
+        resultats->nb_nuls += lot->resultats[t].nb_nuls;
+        resultats->nb_defaites += lot->resultats[t].nb_defaites;
+        resultats->nb_coups += lot->resultats[t].nb_coups;
+    }
+}
+
+/** Boucle principale de l'algorithme MCTS-UCT sur l'arbre d'un thread
+    (instrumenter étant une constante à chaque appel, la boucle est compilée avec et sans relevé des statistiques) */
+static inline __attribute__((always_inline)) void boucleRecherche(RechercheThread * recherche, const bool instrumenter) {
+    Arene * arene = recherche->arbre->arene;
+    TableTransposition * table = recherche->arbre->table;
+    IndiceNoeud racine = recherche->arbre->racine;
+    Etat * etatRacine = &recherche->arbre->etatRacine;
+    PolitiqueSimulation politique = recherche->optimisationLevel >= 4 ? MENACES
+                                  : (recherche->optimisationLevel >= 1 ? COUP_GAGNANT : ALEATOIRE);
+    StatistiquesRecherche * statistiques = recherche->statistiques;
+    Chemin chemin;
+    uint64_t cycles[4];
+
+    ControleTemps controle;
+    initControle(&controle, recherche->budget);
+
+    recherche->iter = 0;
+    recherche->simulations = 0;
+    recherche->refus = 0;
+    do {
+        ResultatsSimulations resultats = { 0, 0, 0, 0 };
+        // Une fois le budget de noeuds atteint, on simule à partir du noeud sélectionné sans le développer
+        bool developper = __atomic_load_n(&arene->nb_elements, __ATOMIC_RELAXED) < recherche->noeudsmax;
+        if (!developper)
+            recherche->refus++;
+
+        if (instrumenter)
+            cycles[0] = compteurCycles();
+        // Sélection
+        if (recherche->arbrePartage)
+            selectionUCBPartagee(arene, racine, etatRacine, &chemin);
+        else
+            selectionUCB(arene, racine, etatRacine, &chemin);
+        if (instrumenter)
+            cycles[1] = compteurCycles();
+        // Expansion
+        if (developper) {
+            if (recherche->arbrePartage)
+                expansionNoeudPartagee(arene, &chemin, &recherche->alea);
+            else
+                expansionNoeud(arene, table, &chemin, &recherche->alea);
+        }
+        if (instrumenter)
+            cycles[2] = compteurCycles();
+        // Simulation (inutile à partir d'un noeud dont le résultat est prouvé : il compte pour chaque simulation)
+        int simulees = 0;
+        FinDePartie resultat = recherche->solveur ? resultatProuve(NOEUD(arene, chemin.noeuds[chemin.longueur - 1])) : NON;
+        if (resultat == ORDI_GAGNE)
+            resultats.nb_victoires = recherche->simulationsParFeuille;
+        else if (resultat == HUMAIN_GAGNE)
+            resultats.nb_defaites = recherche->simulationsParFeuille;
+        else if (resultat == MATCHNUL)
+            resultats.nb_nuls = recherche->simulationsParFeuille;
+        else {
+            simulerFeuille(recherche, &chemin.etat, politique, &resultats);
+            simulees = resultats.nb_victoires + resultats.nb_nuls + resultats.nb_defaites;
+        }
+        recherche->simulations += simulees;
+        if (instrumenter)
+            cycles[3] = compteurCycles();
+        // Propagation
+        if (recherche->arbrePartage)
+            propagerResultatsPartage(arene, &chemin, &resultats);
+        else
+            propagerResultats(arene, &chemin, &resultats);
+        if (recherche->solveur)
+            propagerPreuves(arene, &chemin);
+
+        if (instrumenter) {
+            statistiques->cycles_selection += cycles[1] - cycles[0];
+            statistiques->cycles_expansion += cycles[2] - cycles[1];
+            statistiques->cycles_simulation += cycles[3] - cycles[2];
+            statistiques->cycles_propagation += compteurCycles() - cycles[3];
+            statistiques->nb_simulations += simulees;
+            statistiques->nb_coups_simules += resultats.nb_coups;
+            statistiques->somme_profondeurs += chemin.longueur - 1;
+            if (statistiques->profondeur_max < chemin.longueur - 1)
+                statistiques->profondeur_max = chemin.longueur - 1;
+        }
+
+        recherche->iter ++;
+    } while ( (recherche->iterationsmax <= 0 || recherche->iter < recherche->iterationsmax) && !budgetEpuise(&controle)
+              && resultatProuve(NOEUD(arene, racine)) == NON );   // la recherche s'arrête dès que la racine est prouvée
+
+    if (instrumenter)
+        statistiques->nb_iterations += recherche->iter;
+    recherche->temps = tempsEcoule(recherche->budget);
+}
+
+static void * rechercheMCTS(void * arg) {
+    RechercheThread * recherche = (RechercheThread *)arg;
 
+    if (recherche->statistiques != NULL)
+        boucleRecherche(recherche, true);
+    else
+        boucleRecherche(recherche, false);
+
+    return NULL;
+}
+
+/** Ecrit les statistiques d'une recherche sous la forme d'une ligne JSON */
+static void exporterStatistiques(FILE * fichier, Etat * etat, int colonne, int nbThreads, double temps, int iter,
+                                 uint32_t nbNoeuds, uint32_t noeudsAlloues, StatistiquesRecherche * statistiques) {
+    long long nbIterations = statistiques->nb_iterations > 0 ? statistiques->nb_iterations : 1;
+    long long nbSimulations = statistiques->nb_simulations > 0 ? statistiques->nb_simulations : 1;
+
+    fprintf(fichier, "{\"coup\":%d,\"colonne\":%d,\"threads\":%d,\"temps\":%0.6f,\"iterations\":%d,"
+                     "\"iterations_par_seconde\":%0.1f,\"simulations\":%lld,\"noeuds\":%u,\"noeuds_alloues\":%u,"
+                     "\"profondeur_max\":%d,\"profondeur_moyenne\":%0.3f,\"longueur_moyenne_simulation\":%0.3f,"
+                     "\"cycles\":{\"selection\":%llu,\"expansion\":%llu,\"simulation\":%llu,\"propagation\":%llu}}\n",
+            etat->nb_coups, colonne, nbThreads, temps, iter,
+            temps > 0 ? iter / temps : 0, statistiques->nb_simulations, nbNoeuds, noeudsAlloues,
+            statistiques->profondeur_max, (double)statistiques->somme_profondeurs / nbIterations,
+            (double)statistiques->nb_coups_simules / nbSimulations,
+            (unsigned long long)statistiques->cycles_selection, (unsigned long long)statistiques->cycles_expansion,
+            (unsigned long long)statistiques->cycles_simulation, (unsigned long long)statistiques->cycles_propagation);
+    fflush(fichier);
+}
+
+void ordijoue_mcts(Etat * etat, ParametresMCTS * parametres) {
+    jouerCoupMCTS(&moteurOrdi, etat, parametres);
+}
+
+/** Vérifie les paramètres de l'algorithme (le programme s'arrête s'ils sont incorrects) */
+static void verifierParametres(ParametresMCTS * parametres) {
 	// Condition d'arrêt de l'algorithme inexistante
-	if (tempsmax <= 0 && iterationsmax <= 0) {
+	if (parametres->tempsmax <= 0 && parametres->iterationsmax <= 0 && parametres->annulation == NULL) {
         fprintf(stderr, "Condition d'arrêt inexsitante pour l'algorithme MCTS : le temps ou le nombre d'itérations maximal doit être précisé.");
         exit(EXIT_FAILURE);
 	}
+	if (parametres->nbThreads < 1 || parametres->nbThreads > NB_THREADS_MAX) {
+        fprintf(stderr, "Nombre de threads incorrect pour l'algorithme MCTS : il doit être compris entre 1 et %d.", NB_THREADS_MAX);
+        exit(EXIT_FAILURE);
+	}
+	if (parametres->simulationsParFeuille < 1) {
+        fprintf(stderr, "Nombre de simulations par feuille incorrect pour l'algorithme MCTS : il doit être positif non nul.");
+        exit(EXIT_FAILURE);
+	}
+}
+
+/** Retourne le nb d'arbres développés selon le mode de parallélisation
+    (chaque thread développe son propre arbre uniquement avec la parallélisation à la racine) */
+static int nombreArbres(ParametresMCTS * parametres) {
+    return parametres->parallelisation == RACINE ? parametres->nbThreads : 1;
+}
+
+/** Reprend les arbres du moteur à partir de l'état donné et crée les fils de leurs racines
+    (ajoute à simusReutilisees les simulations conservées et à noeudsLiberes les noeuds libérés) */
+static void preparerArbres(MoteurMCTS * moteur, ParametresMCTS * parametres, Etat * etat, int * simusReutilisees, uint32_t * noeudsLiberes) {
+	int nbArbres = nombreArbres(parametres);
+	int t;
+	for (t = 0 ; t < nbArbres ; t++) {
+		// l'arbre partagé n'utilise pas la table de transposition
+		moteur->arbres[t].transposition = parametres->parallelisation != ARBRE_PARTAGE;
+
+		// Reprendre l'arbre de recherche du coup précédent (ou en créer un nouveau)
+		uint32_t noeudsAvant = moteur->arbres[t].arene != NULL ? moteur->arbres[t].arene->nb_elements : 0;
+		IndiceNoeud racine = reprendreArbre(&moteur->arbres[t], etat);
+		Arene * arene = moteur->arbres[t].arene;
+		*simusReutilisees += NOEUD(arene, racine)->nb_simus;
+		if (noeudsAvant > arene->nb_elements)
+			*noeudsLiberes += noeudsAvant - arene->nb_elements;
+
+		// créer les premiers noeuds (ceux qui n'existent pas déjà):
+		unsigned int coups = NOEUD(arene, racine)->coups_non_developpes;
+		while ( coups != 0 ) {
+			Coup coup = { __builtin_ctz(coups) };
+			coups &= coups - 1;
+			Etat etatEnfant = *etat;
+			jouerCoup(&etatEnfant, &coup);
+			if (moteur->arbres[t].transposition)
+				ajouterEnfantTransposition(arene, moteur->arbres[t].table, racine, &coup, &etatEnfant);
+			else
+				ajouterEnfant(arene, racine, &coup, &etatEnfant);
+		}
+	}
+}
+
+/** Développe les arbres du moteur (préparés par preparerArbres) jusqu'à épuisement du budget
+    avec les threads demandés par les paramètres
+    (ajoute à iter, simulations et refus les nb d'itérations, de simulations réalisées et d'expansions refusées, et à statistiques,
+    si elles sont relevées, celles de chaque thread ; temps reçoit le temps utilisé) */
+static void lancerRecherche(MoteurMCTS * moteur, ParametresMCTS * parametres, BudgetTemps * budget,
+                            int * iter, long long * simulations, int * refus, double * temps, StatistiquesRecherche * statistiques) {
+	int nbThreads = parametres->nbThreads;
+	Parallelisation parallelisation = parametres->parallelisation;
+	int t;
 
-	clock_t tic, toc;
-	tic = clock();
+	// Nb de threads qui développent un arbre
+	int nbThreadsRecherche = parallelisation == FEUILLES ? 1 : nbThreads;
+	// Budget de noeuds de chaque arbre
+	uint32_t noeudsmaxArbre = parametres->noeudsmax > 0 ? (uint32_t)(parametres->noeudsmax / nombreArbres(parametres)) : UINT32_MAX;
+
+    RechercheThread recherches[NB_THREADS_MAX];
+    StatistiquesRecherche statistiquesThreads[NB_THREADS_MAX];
+    pthread_t threads[NB_THREADS_MAX];
+
+    // Les threads de simulation attendent les lots du thread appelant
+    LotSimulations lot;
+    ThreadSimulation threadsSimulation[NB_THREADS_MAX];
+    bool lotParallele = parallelisation == FEUILLES && nbThreads > 1;
+    if (lotParallele) {
+        lot.nbThreads = nbThreads;
+        lot.termine = false;
+        for (t = 0 ; t < nbThreads ; t++) {
+            lot.alea[t] = *parametres->alea;
+            sautAlea(parametres->alea);
+        }
+        pthread_barrier_init(&lot.debutLot, NULL, nbThreads);
+        pthread_barrier_init(&lot.finLot, NULL, nbThreads);
+        for (t = 1 ; t < nbThreads ; t++) {
+            threadsSimulation[t].lot = &lot;
+            threadsSimulation[t].t = t;
+            if (pthread_create(&threads[t], NULL, threadSimulation, &threadsSimulation[t]) != 0) {
+                fprintf(stderr, "Impossible de créer un thread pour l'algorithme MCTS.");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    for (t = 0 ; t < nbThreadsRecherche ; t++) {
+        recherches[t].arbre = &moteur->arbres[parallelisation == RACINE ? t : 0];
+        recherches[t].arbrePartage = parallelisation == ARBRE_PARTAGE && nbThreads > 1;
+        recherches[t].lot = lotParallele ? &lot : NULL;
+        recherches[t].budget = budget;
+        recherches[t].iterationsmax = parametres->iterationsmax;
+        recherches[t].optimisationLevel = parametres->optimisationLevel;
+        recherches[t].solveur = parametres->optimisationLevel >= 3;
+        recherches[t].simulationsParFeuille = parametres->simulationsParFeuille;
+        recherches[t].noeudsmax = noeudsmaxArbre;
+        recherches[t].statistiques = NULL;
+        if (statistiques != NULL) {
+            StatistiquesRecherche aucune = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+            statistiquesThreads[t] = aucune;
+            recherches[t].statistiques = &statistiquesThreads[t];
+        }
+        // chaque thread reçoit une suite indépendante (le générateur de la recherche avance de 2^128 tirages)
+        recherches[t].alea = *parametres->alea;
+        sautAlea(parametres->alea);
+    }
+    // Le premier arbre est développé par le thread appelant
+    for (t = 1 ; t < nbThreadsRecherche ; t++) {
+        if (pthread_create(&threads[t], NULL, rechercheMCTS, &recherches[t]) != 0) {
+            fprintf(stderr, "Impossible de créer un thread pour l'algorithme MCTS.");
+            exit(EXIT_FAILURE);
+        }
+    }
+    rechercheMCTS(&recherches[0]);
+    for (t = 1 ; t < nbThreadsRecherche ; t++)
+        pthread_join(threads[t], NULL);
+
+    if (lotParallele) {
+        // On réveille les threads de simulation pour qu'ils se terminent
+        lot.termine = true;
+        pthread_barrier_wait(&lot.debutLot);
+        for (t = 1 ; t < nbThreads ; t++)
+            pthread_join(threads[t], NULL);
+        pthread_barrier_destroy(&lot.debutLot);
+        pthread_barrier_destroy(&lot.finLot);
+    }
+
+    *temps = 0;
+    for (t = 0 ; t < nbThreadsRecherche ; t++) {
+        *iter += recherches[t].iter;
+        *simulations += recherches[t].simulations;
+        *refus += recherches[t].refus;
+        if (statistiques != NULL) {
+            StatistiquesRecherche * statistiquesThread = &statistiquesThreads[t];
+            statistiques->cycles_selection += statistiquesThread->cycles_selection;
+            statistiques->cycles_expansion += statistiquesThread->cycles_expansion;
+            statistiques->cycles_simulation += statistiquesThread->cycles_simulation;
+            statistiques->cycles_propagation += statistiquesThread->cycles_propagation;
+            statistiques->nb_iterations += statistiquesThread->nb_iterations;
+            statistiques->nb_simulations += statistiquesThread->nb_simulations;
+            statistiques->nb_coups_simules += statistiquesThread->nb_coups_simules;
+            statistiques->somme_profondeurs += statistiquesThread->somme_profondeurs;
+            if (statistiques->profondeur_max < statistiquesThread->profondeur_max)
+                statistiques->profondeur_max = statistiquesThread->profondeur_max;
+        }
+        if (*temps < recherches[t].temps)
+            *temps = recherches[t].temps;
+    }
+}
+
+/** Boucle du thread de réflexion d'un moteur : développe ses arbres à partir de l'état de la réflexion
+    jusqu'à ce qu'elle soit arrêtée (ou que le budget de temps ou d'itérations d'un coup soit épuisé) */
+static void * threadReflexion(void * arg) {
+    MoteurMCTS * moteur = (MoteurMCTS *)arg;
+    ParametresMCTS * parametres = &moteur->parametresReflexion;
+    int simusReutilisees = 0, iter = 0, refus = 0;
+    long long simulations = 0;
+    uint32_t noeudsLiberes = 0;
+    double temps;
+
+    preparerArbres(moteur, parametres, &moteur->etatReflexion, &simusReutilisees, &noeudsLiberes);
+
+    BudgetTemps budget;
+    demarrerBudget(&budget, parametres->tempsmax, parametres->annulation);
+    lancerRecherche(moteur, parametres, &budget, &iter, &simulations, &refus, &temps, NULL);
+
+    // (lu par le thread du moteur une fois la réflexion arrêtée)
+    moteur->nb_iterations_reflexion += iter;
+    moteur->nb_simulations += simulations;
+    moteur->temps += temps;
+    return NULL;
+}
+
+void commencerReflexion(MoteurMCTS * moteur, Etat * etat, ParametresMCTS * parametres) {
+    arreterReflexion(moteur);
+    if (testFin(etat) != NON)
+        return;
+    // le prochain coup du moteur sera calculé par le solveur exact : ses arbres ne serviront pas
+    if (NB_CASES - etat->nb_coups - 1 <= parametres->casesFinale)
+        return;
+
+    moteur->etatReflexion = *etat;
+    moteur->parametresReflexion = *parametres;
+    moteur->parametresReflexion.annulation = &moteur->arretReflexion;
+    // la réflexion tire ses nombres d'une suite indépendante de celle de l'appelant
+    moteur->aleaReflexion = *parametres->alea;
+    sautAlea(parametres->alea);
+    moteur->parametresReflexion.alea = &moteur->aleaReflexion;
+    moteur->parametresReflexion.statistiques = NULL;
+    moteur->parametresReflexion.verboseLevel = 0;
+    verifierParametres(&moteur->parametresReflexion);
+
+    moteur->arretReflexion = 0;
+    if (pthread_create(&moteur->threadReflexion, NULL, threadReflexion, moteur) != 0) {
+        fprintf(stderr, "Impossible de créer le thread de réflexion de l'algorithme MCTS.");
+        exit(EXIT_FAILURE);
+    }
+    moteur->reflexion = true;
+}
+
+void arreterReflexion(MoteurMCTS * moteur) {
+    if (!moteur->reflexion)
+        return;
+
+    __atomic_store_n(&moteur->arretReflexion, 1, __ATOMIC_RELAXED);
+    pthread_join(moteur->threadReflexion, NULL);
+    moteur->reflexion = false;
+}
+
+void ordireflechit_mcts(Etat * etat, ParametresMCTS * parametres) {
+    commencerReflexion(&moteurOrdi, etat, parametres);
+}
+
+/** Si la position est dans le livre d'ouvertures, joue le coup choisi parmi ses statistiques
+    avec la méthode methodeChoix, le range dans coup et retourne true (sinon retourne false) */
+static bool jouerCoupLivre(MoteurMCTS * moteur, Etat * etat, ParametresMCTS * parametres, Coup * coup) {
+    EntreeLivre entree;
+    if (!chercherLivre(parametres->livre, etat, &entree))
+        return false;
+
+    unsigned int coups = masque_coups_possibles(etat);
+    uint32_t total = 0;
+    double maxValeurs = -1;
+    int c, meilleur = -1;
+    for (c = 0 ; c < NB_COLONNES ; c++) {
+        if ((coups & (1u << c)) == 0 || entree.nb_simus[c] == 0)
+            entree.nb_simus[c] = entree.nb_victoires[c] = 0;
+        else {
+            double valeur = parametres->methodeChoix == ROBUSTE ? entree.nb_simus[c]
+                                                                : (double)entree.nb_victoires[c] / entree.nb_simus[c];
+            if (maxValeurs < valeur) {
+                maxValeurs = valeur;
+                meilleur = c;
+            }
+            total += entree.nb_simus[c];
+        }
+        moteur->simus_coups[c] = entree.nb_simus[c];
+        moteur->victoires_coups[c] = entree.nb_victoires[c];
+    }
+    if (meilleur < 0)       // aucune statistique utilisable
+        return false;
+
+    // Affichage du nombre de simulations du livre pour chaque coup
+    if (parametres->verboseLevel >= 3) {
+        for (c = 0 ; c < NB_COLONNES ; c++)
+            if (entree.nb_simus[c] > 0)
+                printf("\nPour le coup en colonne %d :   Nombre de simulations   : %u", c, entree.nb_simus[c]);
+        printf("\n");
+    }
+    if (parametres->verboseLevel >= 1) {
+        printf("\nCoup joué en colonne %d (livre d'ouvertures)", meilleur);
+        printf("\nNombre total de simulations : %u", total);
+        printf("\nEstimation de probabilité de victoire pour l'ordinateur : %0.2f %%\n",
+               (double)entree.nb_victoires[meilleur] / entree.nb_simus[meilleur] * 100);
+    }
+
+    coup->colonne = meilleur;
+    jouerCoup(etat, coup);
+    moteur->nb_coups_livre++;
+    return true;
+}
+
+/** Si la position est résolue par le solveur exact dans son budget (la moitié du temps maximal),
+    joue le coup trouvé, le range dans coup et retourne true (sinon retourne false) */
+static bool jouerCoupFinale(MoteurMCTS * moteur, Etat * etat, ParametresMCTS * parametres, Coup * coup) {
+    if (moteur->finale == NULL)
+        moteur->finale = nouveauSolveur();
+
+    // La résolution dispose de la moitié de la limite de temps
+    // ou, sans limite de temps, d'un nb de positions équivalent à la moitié de la limite d'itérations
+    BudgetTemps budget;
+    demarrerBudget(&budget, parametres->tempsmax > 0 ? parametres->tempsmax / 2 : -1, parametres->annulation);
+    long long noeudsmax = parametres->tempsmax <= 0 && parametres->iterationsmax > 0
+                        ? (long long)parametres->iterationsmax * FINALE_NOEUDS_PAR_ITERATION / 2 : 0;
+    int colonne, score;
+    if (!resoudreFinale(moteur->finale, etat, &budget, noeudsmax, &colonne, &score)) {
+        if (parametres->verboseLevel >= 2)
+            printf("\nSolveur exact interrompu après %lld positions (%0.4fs) : recherche MCTS\n",
+                   moteur->finale->nb_noeuds, tempsEcoule(&budget));
+        return false;
+    }
+
+    // les statistiques de la dernière recherche n'ont pas de sens ici
+    int c;
+    for (c = 0 ; c < LARGEUR_MAX ; c++)
+        moteur->simus_coups[c] = moteur->victoires_coups[c] = 0;
+
+    if (parametres->verboseLevel >= 2)
+        printf("\nTemps utilisé       : %0.4fs"
+               "\nPositions explorées : %lld\n", tempsEcoule(&budget), moteur->finale->nb_noeuds);
+    if (parametres->verboseLevel >= 1) {
+        printf("\nCoup joué en colonne %d (solveur exact)", colonne);
+        if (score > 0)
+            printf("\nVictoire de l'ordinateur prouvée (score %d)", score);
+        else if (score < 0)
+            printf("\nDéfaite de l'ordinateur prouvée (score %d)", score);
+        else
+            printf("\nMatch nul prouvé");
+        printf("\n");
+    }
+
+    coup->colonne = colonne;
+    jouerCoup(etat, coup);
+    moteur->nb_coups_finale++;
+    return true;
+}
+
+Coup jouerCoupMCTS(MoteurMCTS * moteur, Etat * etat, ParametresMCTS * parametres) {
+
+	MethodeChoixCoup methodeChoix = parametres->methodeChoix;
+	int optimisationLevel = parametres->optimisationLevel;
+	int nbThreads = parametres->nbThreads;
+	int verboseLevel = parametres->verboseLevel;
+
+	verifierParametres(parametres);
+
+	// La réflexion éventuelle pendant le tour de l'adversaire s'arrête : ses arbres sont repris ci-dessous
+	arreterReflexion(moteur);
+
+	// Coup du livre d'ouvertures (joué sans recherche)
+	Coup meilleur_coup;
+	if (parametres->livre != NULL && jouerCoupLivre(moteur, etat, parametres, &meilleur_coup))
+		return meilleur_coup;
+
+	BudgetTemps budget;
+	demarrerBudget(&budget, parametres->tempsmax, parametres->annulation);
 	double temps = 0;
 
-	Coup ** coups;
+	// Fin de partie résolue exactement (la recherche MCTS n'a lieu que si la résolution n'aboutit pas à temps)
+	if (NB_CASES - etat->nb_coups <= parametres->casesFinale && jouerCoupFinale(moteur, etat, parametres, &meilleur_coup))
+		return meilleur_coup;
+
 	Noeud * noeudMeilleurCoup = NULL;
-	Coup * meilleur_coup;
-
-	// Créer l'arbre de recherche
-	Noeud * racine = nouveauNoeud(NULL, NULL);
-	racine->etat = copieEtat(etat);
-
-	// créer les premiers noeuds:
-	coups = coups_possibles(racine->etat);
-	int k = 0;
-	Noeud * enfant;
-	while ( coups[k] != NULL) {
-		enfant = ajouterEnfant(racine, coups[k]);
-		k++;
+	IndiceNoeud indiceMeilleurCoup = AUCUN_NOEUD;
+	int simusReutilisees = 0;
+	uint32_t noeudsLiberes = 0;
+	int i, t;
+
+	int nbArbres = nombreArbres(parametres);
+	preparerArbres(moteur, parametres, etat, &simusReutilisees, &noeudsLiberes);
+
+	// Les arbres des threads sont agrégés dans une racine supplémentaire de l'arène du premier arbre
+	// (elle n'est pas rattachée à l'arbre : elle sera libérée lors de la reprise de l'arbre)
+	Arene * arene = moteur->arbres[0].arene;
+	IndiceNoeud racine = nouveauNoeud(arene, etat);
+	Noeud * racineArbre = NOEUD(arene, moteur->arbres[0].racine);
+	for (i = 0 ; i < racineArbre->nb_enfants ; i++) {
+		Coup coup = { racineArbre->colonnes[i] };
+		Etat etatEnfant = *etat;
+		jouerCoup(&etatEnfant, &coup);
+		IndiceNoeud enfant = ajouterEnfant(arene, racine, &coup, &etatEnfant);
+
 		// Si le niveau d'optimisation et suffisant et qu'un coup gagnant est possible
-		if (optimisationLevel >= 2 && testFin(enfant->etat) == ORDI_GAGNE)
-            noeudMeilleurCoup = enfant;   // on le joue tout de suite
+		if (optimisationLevel >= 2 && testFin(&etatEnfant) == ORDI_GAGNE)
+			indiceMeilleurCoup = enfant;   // on le joue tout de suite
 	}
 
-	/* Algorithme MCTS-UCS */
+	/* Algorithme MCTS-UCS (parallélisé à la racine, sur un arbre partagé ou aux feuilles) */
 	int iter = 0;
+	long long simulations = 0;
+	int refus = 0;
 
-    if (noeudMeilleurCoup == NULL) {    // Optimisation
-        do {
-            // Sélection
-            Noeud * noeudSelectionne = selectionUCB(racine);
-            // Expansion
-            enfant = expansionNoeud(noeudSelectionne);
-            // Simulation
-            Etat * etatCopie = copieEtat(enfant->etat);
-            bool choisirCoupGagnant = optimisationLevel >= 1;
-            FinDePartie resultat = simulerPartie(etatCopie, choisirCoupGagnant);
-            free(etatCopie);
-            // Propagation
-            propagerResultat(enfant, resultat);
+	// Statistiques exportées de la recherche (relevées par chaque thread puis sommées)
+	StatistiquesRecherche statistiques = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+	uint32_t noeudsAvantRecherche = 0;
+	for (t = 0 ; t < nbArbres ; t++)
+		noeudsAvantRecherche += moteur->arbres[t].arene->nb_elements;
 
-            toc = clock();
-            temps = ((double) (toc - tic))/ CLOCKS_PER_SEC;
-            iter ++;
-        } while ( (tempsmax <= 0 || temps < tempsmax) && (iterationsmax <= 0 || iter < iterationsmax) );
+    if (indiceMeilleurCoup == AUCUN_NOEUD)      // Optimisation
+        lancerRecherche(moteur, parametres, &budget, &iter, &simulations, &refus, &temps,
+                        parametres->statistiques != NULL ? &statistiques : NULL);
 
-        // On cherche le meilleur coup possible
-        noeudMeilleurCoup = trouverNoeudMeilleurCoup(racine, methodeChoix);
+    // On somme les statistiques des fils de la racine de chaque arbre
+    Noeud * noeudRacine = NOEUD(arene, racine);
+    for (t = 0 ; t < nbArbres ; t++) {
+        Arene * areneThread = moteur->arbres[t].arene;
+        Noeud * racineThread = NOEUD(areneThread, moteur->arbres[t].racine);
+
+        noeudRacine->nb_simus += racineThread->nb_simus;
+        for (i = 0 ; i < noeudRacine->nb_enfants ; i++) {
+            Noeud * enfant = NOEUD(arene, noeudRacine->enfants[i]);
+            Noeud * enfantThread = NOEUD(areneThread, enfantColonne(areneThread, moteur->arbres[t].racine, noeudRacine->colonnes[i]));
+            enfant->nb_simus += enfantThread->nb_simus;
+            enfant->nb_victoires += enfantThread->nb_victoires;
+            enfant->sommes_recompenses += enfantThread->sommes_recompenses;
+            // un résultat prouvé dans l'un des arbres est exact
+            if (enfantThread->resultat_prouve != NON)
+                enfant->resultat_prouve = enfantThread->resultat_prouve;
+        }
     }
 
-        meilleur_coup = noeudMeilleurCoup->coup;
+    // Statistiques de chaque coup conservées dans le moteur
+    for (i = 0 ; i < LARGEUR_MAX ; i++)
+        moteur->simus_coups[i] = moteur->victoires_coups[i] = 0;
+    for (i = 0 ; i < noeudRacine->nb_enfants ; i++) {
+        Noeud * enfant = NOEUD(arene, noeudRacine->enfants[i]);
+        moteur->simus_coups[(int)noeudRacine->colonnes[i]] = enfant->nb_simus;
+        moteur->victoires_coups[(int)noeudRacine->colonnes[i]] = enfant->nb_victoires;
+    }
+
+    // On cherche le meilleur coup possible
+    if (indiceMeilleurCoup == AUCUN_NOEUD)
+        indiceMeilleurCoup = trouverNoeudMeilleurCoup(arene, racine, methodeChoix);
+    noeudMeilleurCoup = NOEUD(arene, indiceMeilleurCoup);
+
+        meilleur_coup.colonne = colonneEnfant(arene, racine, indiceMeilleurCoup);
 
 	/* fin de l'algorithme  */
 
+    uint32_t nbNoeuds = 0;
+    for (t = 0 ; t < nbArbres ; t++)
+        nbNoeuds += moteur->arbres[t].arene->nb_elements;
+
+    // Export des statistiques de la recherche
+    if (parametres->statistiques != NULL)
+        exporterStatistiques(parametres->statistiques, etat, meilleur_coup.colonne, nbThreads, temps, iter,
+                             nbNoeuds, nbNoeuds - noeudsAvantRecherche, &statistiques);
+
     // Affichage du temps passé dans la boucle principale de l'algorithme MCTS et du nombre d'itérations.
-    if (verboseLevel >= 2)
+    if (verboseLevel >= 2) {
         printf("\nTemps utilisé       : %0.4fs"
-               "\nNombre d'itérations : %d\n", temps, iter);
+               "\nNombre d'itérations : %d"
+               "\nSimulations réutilisées du coup précédent : %d"
+               "\nNombre de noeuds    : %u", temps, iter, simusReutilisees, nbNoeuds);
+        if (parametres->noeudsmax > 0)
+            printf(" (max %d)", parametres->noeudsmax);
+        printf("\nNoeuds libérés à la reprise de l'arbre : %u"
+               "\nExpansions refusées faute de mémoire   : %d\n", noeudsLiberes, refus);
+    }
 
     // Affichage du nombre de simulations réalisées pour chaque coup
     if (verboseLevel >= 3) {
-        int i;
-        for (i=0 ; i < racine->nb_enfants ; i++) {
-            Noeud * noeud = racine->enfants[i];
-            printf("\nPour le coup en colonne %d :   Nombre de simulations   : %d", noeud->coup->colonne, noeud->nb_simus);
+        for (i=0 ; i < noeudRacine->nb_enfants ; i++) {
+            Noeud * noeud = NOEUD(arene, noeudRacine->enfants[i]);
+            printf("\nPour le coup en colonne %d :   Nombre de simulations   : %d", noeudRacine->colonnes[i], noeud->nb_simus);
+            if (noeud->resultat_prouve != NON)
+                printf("   (%s prouvé)", noeud->resultat_prouve == ORDI_GAGNE ? "gain" : (noeud->resultat_prouve == MATCHNUL ? "nul" : "perte"));
             // et de la récompense moyenne pour chaque coup
             if (verboseLevel >= 4) {
                 printf("\n                              Moyenne des récompenses : ");
@@ -345,20 +1518,35 @@ void ordijoue_mcts(Etat * etat, double tempsmax, int iterationsmax, MethodeChoix
     // Affichage du nombre de simulations réalisées pour calculer le meilleur coup
     // et une estimation de la probabilité de victoire pour l'ordinateur
     if (verboseLevel >= 1) {
-        printf("\nCoup joué en colonne %d", noeudMeilleurCoup->coup->colonne);
-        printf("\nNombre total de simulations : %d", racine->nb_simus);
+        printf("\nCoup joué en colonne %d", meilleur_coup.colonne);
+        printf("\nNombre total de simulations : %d", noeudRacine->nb_simus);
         printf("\nEstimation de probabilité de victoire pour l'ordinateur : ");
         if (noeudMeilleurCoup->nb_simus > 0)
             printf("%0.2f %%", (double)noeudMeilleurCoup->nb_victoires/noeudMeilleurCoup->nb_simus * 100);
         else
             printf("aucune");
+        // (le meilleur coup n'est prouvé perdant que si tous les coups le sont)
+        if (noeudMeilleurCoup->resultat_prouve == ORDI_GAGNE)
+            printf("\nVictoire de l'ordinateur prouvée");
+        else if (noeudMeilleurCoup->resultat_prouve == HUMAIN_GAGNE)
+            printf("\nDéfaite de l'ordinateur prouvée");
         printf("\n");
     }
 
 	// Jouer le meilleur premier coup
-	jouerCoup(etat, meilleur_coup);
+	jouerCoup(etat, &meilleur_coup);
+
+	// Le sous-arbre du coup joué est conservé dans chaque arbre pour le prochain coup de l'ordinateur
+	// (le reste des arbres sera libéré d'un coup lors de leur reprise)
+	for (t = 0 ; t < nbArbres ; t++) {
+		moteur->arbres[t].racine = enfantColonne(moteur->arbres[t].arene, moteur->arbres[t].racine, meilleur_coup.colonne);
+		moteur->arbres[t].etatRacine = *etat;
+	}
+
+	moteur->nb_recherches++;
+	moteur->nb_iterations += iter;
+	moteur->nb_simulations += simulations;
+	moteur->temps += temps;
 
-	// Penser à libérer la mémoire :
-	freeNoeud(racine);
-	free (coups);
+	return meilleur_coup;
 }
@@ -2,7 +2,14 @@
 #define MCTS_H_INCLUDED
 
 #include "puissance4.h"
+#include "arene.h"
+#include "alea.h"
+#include "transposition.h"
+#include "livre.h"
+#include "finale.h"
 #include <stdbool.h>
+#include <stdio.h>
+#include <pthread.h>
 
 /**
     Fonctions d'implémentation de l'algorithme MCTS avec UCB (UCT).
@@ -11,82 +18,347 @@
 /** Méthode du choix du coup à jouer pour MCTS */
 typedef enum { MAX, ROBUSTE } MethodeChoixCoup;
 
-/** Definition du type Noeud */
-typedef struct NoeudSt {
+/** Mode de parallélisation de MCTS :
+    RACINE : un arbre indépendant par thread, agrégés à la racine
+    ARBRE_PARTAGE : tous les threads développent le même arbre
+    FEUILLES : un seul thread développe l'arbre, les simulations de chaque feuille sont réparties entre les threads */
+typedef enum { RACINE, ARBRE_PARTAGE, FEUILLES } Parallelisation;
+
+/** Politique de choix des coups pendant les simulations :
+    ALEATOIRE : coups joués au hasard
+    COUP_GAGNANT : l'ordinateur joue un coup gagnant lorsque cela est possible (sinon au hasard)
+    MENACES : chaque joueur joue un coup gagnant lorsque cela est possible,
+              sinon bloque un coup gagnant de l'adversaire, sinon joue au hasard */
+typedef enum { ALEATOIRE, COUP_GAGNANT, MENACES } PolitiqueSimulation;
+
+/** Paramètres de l'algorithme MCTS (voir ordijoue_mcts) */
+typedef struct {
+
+	double tempsmax;                // temps de calcul maximal (en secondes, ignoré si nul ou négatif)
+	int iterationsmax;              // nb d'itérations maximal (ignoré si nul ou négatif)
+	MethodeChoixCoup methodeChoix;  // méthode du choix du coup à jouer
+	int optimisationLevel;          // niveau d'optimisation de l'algorithme
+	int nbThreads;                  // nb de threads
+	Parallelisation parallelisation;    // mode de parallélisation
+	int simulationsParFeuille;      // nb de simulations réalisées à partir de chaque noeud développé
+	int noeudsmax;                  // nb maximal de noeuds de l'ensemble des arbres de recherche (ignoré si nul ou négatif)
+	int verboseLevel;               // niveau de verbosité
+	FILE * statistiques;            // fichier où écrire les statistiques de chaque recherche (une ligne JSON par coup, NULL si aucun)
+	LivreOuvertures * livre;        // livre d'ouvertures consulté avant la recherche (NULL si aucun)
+	int casesFinale;                // nb de cases vides en dessous duquel (ou égal) le solveur exact remplace la recherche (0 pour ne jamais l'utiliser)
+
+	Alea * alea;                    // générateur aléatoire de la recherche (une suite indépendante en est tirée pour chaque thread)
+	int * annulation;               // drapeau d'annulation externe (NULL si aucun) : la recherche s'arrête dès qu'il est non nul
+
+} ParametresMCTS;
+
+/** Résultats d'un lot de simulations */
+typedef struct {
+
+	int nb_victoires;   // ORDI_GAGNE
+	int nb_nuls;        // MATCHNUL
+	int nb_defaites;    // HUMAIN_GAGNE
+	long long nb_coups; // nb total de coups joués pendant les simulations
+
+} ResultatsSimulations;
+
+/** Statistiques d'une recherche, relevées seulement lorsqu'elles sont exportées (voir ParametresMCTS)
+    les durées des phases sont en cycles processeur (voir compteurCycles) */
+typedef struct {
+
+	uint64_t cycles_selection;
+	uint64_t cycles_expansion;
+	uint64_t cycles_simulation;
+	uint64_t cycles_propagation;
+
+	long long nb_iterations;
+	long long nb_simulations;
+	long long nb_coups_simules;     // nb total de coups joués pendant les simulations
+	long long somme_profondeurs;    // somme des profondeurs des noeuds à partir desquels les simulations sont faites
+	int profondeur_max;
+
+} StatistiquesRecherche;
 
-	int joueur; // joueur qui a joué pour arriver ici
-	Coup * coup;   // coup joué par ce joueur pour arriver ici
+/** Nombre maximal de threads (donc d'arbres indépendants) pour MCTS */
+#define NB_THREADS_MAX 64
 
-	Etat * etat; // etat du jeu
+/** Nombre de parties simulées au pas dans un même lot (voir simulerParties) :
+    une partie par entier de 64 bits des registres vectoriels de la machine cible */
+#if defined(__AVX512F__)
+#define LOT_SIMULATIONS 8
+#elif defined(__AVX2__)
+#define LOT_SIMULATIONS 4
+#else
+#define LOT_SIMULATIONS 2
+#endif
 
-	struct NoeudSt * parent;
-	struct NoeudSt * enfants[LARGEUR_MAX]; // liste d'enfants : chaque enfant correspond à un coup possible
-	int nb_enfants;	// nb d'enfants présents dans la liste
+/** Indice d'un noeud dans l'arène de l'arbre de recherche
+    (les noeuds se désignent par leur indice plutôt que par un pointeur) */
+typedef uint32_t IndiceNoeud;
+
+/** Indice d'un noeud inexistant (parent de la racine par exemple) */
+#define AUCUN_NOEUD ARENE_AUCUN
+
+/** Definition du type Noeud
+    (la position n'est pas stockée dans le noeud : elle est reconstruite coup par coup
+    lors de la descente depuis la racine, ce qui permet à un noeud de tenir sur 64 octets au Puissance 4) */
+typedef struct NoeudSt {
 
 	// POUR MCTS:
-	int nb_victoires;   // Pour calculer les stats
 	double sommes_recompenses;  // Pour calculer la B-valeur (car match nul pris en compte)
+	int nb_victoires;   // Pour calculer les stats
 	int nb_simus;
 
+	// POUR L'ARBRE PARTAGÉ ENTRE THREADS:
+	int perte_virtuelle;    // nb de threads en cours de descente par ce noeud (comptés comme des défaites)
+
+	IndiceNoeud enfants[LARGEUR_MAX]; // liste d'enfants : chaque enfant correspond à un coup possible
+	char colonnes[LARGEUR_MAX];       // colonne du coup menant à chaque enfant (à partir de ce noeud)
+	char nb_enfants;	// nb d'enfants présents dans la liste
+	uint16_t coups_non_developpes;  // masque des colonnes jouables sans enfant (0 si l'état est final)
+
+	char joueur;    // joueur qui a joué pour arriver ici
+	char verrou;    // verrou de l'ajout d'enfants (arbre partagé)
+	char resultat_prouve;   // résultat de la position s'il est prouvé (FinDePartie, NON sinon)
+
 } Noeud;
 
-/** Créer un nouveau noeud en jouant un coup à partir d'un parent
-    utiliser nouveauNoeud(NULL, NULL) pour créer la racine */
-Noeud * nouveauNoeud (Noeud * parent, Coup * coup);
+/** Arbre de recherche conservé d'un coup à l'autre */
+typedef struct {
+
+	Arene * arene;              // arène contenant les noeuds de l'arbre
+	Arene * areneCompactage;    // arène de réserve dans laquelle est recopié le sous-arbre conservé
+	IndiceNoeud racine;         // racine de l'arbre (AUCUN_NOEUD si l'arbre est vide)
+	Etat etatRacine;            // position de la racine
+	TableTransposition * table; // noeud de chaque position de l'arbre
+	bool transposition;         // vrai si une position n'est représentée que par un noeud (faux pour l'arbre partagé)
+
+} ArbreRecherche;
+
+/** Chemin parcouru de la racine jusqu'à un noeud lors d'une itération
+    (un noeud pouvant avoir plusieurs parents, c'est le long de ce chemin que les résultats sont propagés) */
+typedef struct {
+
+	IndiceNoeud noeuds[NB_LIGNES * NB_COLONNES + 1];
+	int longueur;
+	Etat etat;      // position du dernier noeud du chemin
 
-/** Ajouter un enfant à un parent en jouant un coup
-    retourne le pointeur sur l'enfant ajouté */
-Noeud * ajouterEnfant(Noeud * parent, Coup * coup);
+} Chemin;
 
-/** Libère la mémoire d'un noeud et de ses enfants récursivement */
-void freeNoeud (Noeud * noeud);
+/** Retourne le noeud d'indice donné de l'arène */
+#define NOEUD(arene, indice) ((Noeud *)elementArene((arene), (indice)))
 
-/** Calcule la B-valeur d'un noeud */
-double calculerBValeurNoeud(Noeud * noeud);
+/** Créer un nouveau noeud dans l'arène pour la position donnée et retourne son indice
+    (la position sert seulement à calculer les coups à développer, elle n'est pas conservée) */
+IndiceNoeud nouveauNoeud (Arene * arene, Etat * etat);
 
-/** Sélectionne récursivement à partir de la racine (passée en paramètre)
+/** Ajouter à un parent l'enfant obtenu en jouant un coup, etat étant la position après ce coup
+    retourne l'indice de l'enfant ajouté
+    (l'enfant n'est visible des autres threads qu'une fois entièrement initialisé) */
+IndiceNoeud ajouterEnfant(Arene * arene, IndiceNoeud parent, Coup * coup, Etat * etat);
+
+/** Ajouter un enfant à un parent comme ajouterEnfant, en réutilisant le noeud de la table de transposition
+    si la position obtenue est déjà dans l'arbre (le noeud et ses statistiques sont alors partagés entre ses parents)
+    retourne l'indice de l'enfant ajouté */
+IndiceNoeud ajouterEnfantTransposition(Arene * arene, TableTransposition * table, IndiceNoeud parent, Coup * coup, Etat * etat);
+
+/** Calcule la B-valeur d'un noeud choisi à partir d'un parent
+    dont on donne le joueur et la racine du logarithme du nombre de simulations
+    (calculée une seule fois pour tous les enfants du parent, voir racineLogSimus)
+    (les threads en cours de descente par ce noeud comptent comme des défaites pour le joueur qui le choisit) */
+double calculerBValeurNoeud(Noeud * noeud, int joueurParent, double racineLogSimusParent);
+
+/** Retourne sqrt(log(nbSimus)) (tabulé pour les petits nombres de simulations) */
+double racineLogSimus(int nbSimus);
+
+/** Sélectionne à partir de la racine (passée en paramètre)
     le noeud avec la plus grande B-valeur jusqu'à arriver à un noeud terminal
-    ou un dont tous les fils n'ont pas été développés */
-Noeud * selectionUCB(Noeud * racine);
+    ou un dont tous les fils n'ont pas été développés.
+    Le chemin parcouru (racine et noeud sélectionné compris) est rangé dans chemin,
+    avec la position du noeud sélectionné rejouée à partir de celle de la racine (etatRacine). */
+IndiceNoeud selectionUCB(Arene * arene, IndiceNoeud racine, Etat * etatRacine, Chemin * chemin);
 
-/** Réalise l'expansion d'un noeud en développant un de ses fils au hasard
-    et retourne ce fils.
+/** Réalise l'expansion du dernier noeud du chemin en développant un de ses fils au hasard (tiré avec alea),
+    ajoute ce fils au chemin (dont la position est mise à jour) et le retourne.
+    Si la table n'est pas NULL, un fils dont la position est déjà dans l'arbre est partagé.
     Si le noeud représente un état final, retourne simplement celui-ci. */
-Noeud * expansionNoeud(Noeud * noeud);
+IndiceNoeud expansionNoeud(Arene * arene, TableTransposition * table, Chemin * chemin, Alea * alea);
 
 /** Simule le déroulement de la partie à partir d'un état
     jusqu'à la fin et retourne l'état final.
-    Si choisirCoupGagnant est à vrai,
-    on améliore les simulations en choisissant un coup gagnant lorsque cela est possible. */
-FinDePartie simulerPartie(Etat * etat, bool choisirCoupGagnant);
+    L'état passé n'est pas modifié : la partie est jouée sur une copie locale, sans allocation.
+    Les coups aléatoires sont tirés avec alea, les autres sont choisis selon la politique
+    (coups gagnants et coups à bloquer obtenus à partir des menaces de chaque joueur, voir casesGagnantes). */
+FinDePartie simulerPartie(Etat * etat, PolitiqueSimulation politique, Alea * alea);
 
-/** Propage le résultat à partir d'un noeud
+/** Simule nbSimulations parties à partir d'un état
+    et ajoute leurs résultats à ceux passés en paramètre.
+    Lorsqu'il y a plusieurs parties, elles sont simulées par lots de LOT_SIMULATIONS parties jouées au pas
+    sur des vecteurs de bitboards (sans branchement propre à une partie : tirage du coup, coup gagnant,
+    pose du pion et test de fin sont réalisés sur toutes les parties du lot à la fois).
+    Les plateaux de 128 bits (voir Bitboard) sont toujours simulés partie par partie. */
+void simulerParties(Etat * etat, int nbSimulations, PolitiqueSimulation politique, Alea * alea, ResultatsSimulations * resultats);
+
+/** Propage le résultat à partir du dernier noeud du chemin
     en remontant le résultat de la partie
-    aux parents de ce noeud.*/
-void propagerResultat(Noeud * noeud, FinDePartie resultat);
+    aux noeuds du chemin.*/
+void propagerResultat(Arene * arene, Chemin * chemin, FinDePartie resultat);
+
+/** Prouve le résultat du dernier noeud du chemin s'il représente un état final
+    puis remonte le chemin tant que le résultat des noeuds est prouvé par celui de leurs fils (MCTS-Solver). */
+void propagerPreuves(Arene * arene, Chemin * chemin);
+
+/** Propage en une seule remontée les résultats d'un lot de simulations
+    réalisées à partir du dernier noeud du chemin aux noeuds du chemin. */
+void propagerResultats(Arene * arene, Chemin * chemin, ResultatsSimulations * resultats);
+
+/** Versions de la sélection, de l'expansion et de la propagation
+    pour un arbre partagé entre plusieurs threads :
+    la sélection ajoute une perte virtuelle à chaque noeud traversé (et l'expansion à l'enfant créé),
+    l'expansion verrouille le noeud développé
+    et la propagation met à jour les statistiques de manière atomique en retirant la perte virtuelle.
+    (l'arbre partagé n'utilise pas la table de transposition) */
+IndiceNoeud selectionUCBPartagee(Arene * arene, IndiceNoeud racine, Etat * etatRacine, Chemin * chemin);
+IndiceNoeud expansionNoeudPartagee(Arene * arene, Chemin * chemin, Alea * alea);
+void propagerResultatsPartage(Arene * arene, Chemin * chemin, ResultatsSimulations * resultats);
 
 /** Trouve le noeud correspondant au meilleur coup possible
     en utilisant la méthode spécifié
-    à partir de la racine. */
-Noeud * trouverNoeudMeilleurCoup(Noeud * racine, MethodeChoixCoup methode);
+    à partir de la racine.
+    Un coup dont la victoire est prouvée est choisi directement, ceux dont la défaite est prouvée sont écartés. */
+IndiceNoeud trouverNoeudMeilleurCoup(Arene * arene, IndiceNoeud racine, MethodeChoixCoup methode);
+
+/** Retourne la racine de l'arbre de recherche correspondant à l'état donné :
+    si l'état est celui de la racine conservée ou d'un de ses fils, ce noeud devient la racine
+    et seul son sous-arbre est conservé (recopié dans l'arène de réserve, le reste étant libéré d'un coup,
+    et la table de transposition reconstruite ; sans transposition, chaque noeud est recopié tel quel),
+    sinon l'arbre est vidé et une nouvelle racine est créée. */
+IndiceNoeud reprendreArbre(ArbreRecherche * arbre, Etat * etat);
+
+/** Moteur MCTS : arbres de recherche (un par thread) conservés d'un coup à l'autre
+    et statistiques cumulées des recherches réalisées.
+    Pendant le tour de l'adversaire, un thread de réflexion peut continuer à développer ses arbres.
+    Plusieurs moteurs peuvent jouer en même temps (dans des threads différents). */
+typedef struct {
+
+	ArbreRecherche arbres[NB_THREADS_MAX];
+
+	int nb_recherches;          // nb de coups calculés
+	long long nb_iterations;    // nb total d'itérations
+	long long nb_simulations;   // nb total de simulations réalisées (y compris pendant la réflexion)
+	double temps;               // temps total passé dans la boucle principale (en secondes, y compris pendant la réflexion)
+	int nb_coups_livre;         // nb de coups joués directement à partir du livre d'ouvertures
+	int nb_coups_finale;        // nb de coups calculés par le solveur exact de fin de partie
+
+	SolveurFinale * finale;     // solveur exact de fin de partie (créé lors de sa première utilisation)
+
+	// Statistiques de chaque coup à l'issue de la dernière recherche (nulles pour les coups impossibles)
+	uint32_t simus_coups[LARGEUR_MAX];
+	uint32_t victoires_coups[LARGEUR_MAX];
+
+	// Réflexion pendant le tour de l'adversaire
+	bool reflexion;                         // vrai si le thread de réflexion est lancé
+	pthread_t threadReflexion;
+	int arretReflexion;                     // drapeau d'annulation de la réflexion
+	Etat etatReflexion;                     // position sur laquelle l'adversaire doit jouer
+	ParametresMCTS parametresReflexion;
+	Alea aleaReflexion;
+	long long nb_iterations_reflexion;      // nb total d'itérations réalisées pendant la réflexion
+
+} MoteurMCTS;
+
+/** Créer un nouveau moteur (sans arbre de recherche) */
+MoteurMCTS * nouveauMoteur(void);
+
+/** Libère la mémoire du moteur et de ses arbres de recherche */
+void freeMoteur(MoteurMCTS * moteur);
+
+/** Libère la mémoire de l'arbre de recherche conservé entre les coups de l'ordinateur */
+void libererArbreMCTS(void);
+
+/** Retourne le nb de noeuds des arbres de recherche tenant dans la mémoire donnée (en octets),
+    en comptant l'arène de réserve et la table de transposition (au pire remplie au quart) */
+int noeudsPourMemoire(double octets);
 
 /** Calcule et joue un coup de l'ordinateur avec MCTS-UCT
     en tempsmax secondes ou avec iterationxmax itérations (selon le plus limitant)
+    (l'arbre de recherche est conservé d'un coup à l'autre : le sous-arbre correspondant
+    à la réponse de l'humain et ses statistiques sont réutilisés lors du coup suivant)
     (l'un de ces deux paramètres peut être ignoré en le mettant à une valeur nulle ou négative)
     et en choisissant le coup à l'aide de la méthode methodeChoix.
+    A chaque itération, simulationsParFeuille simulations sont réalisées à partir du noeud développé
+    et leurs résultats sont propagés en une seule fois.
+
+    *** Parallélisation ***
+    nbThreads threads (entre 1 et NB_THREADS_MAX) sont utilisés selon le mode parallelisation :
+    RACINE        : chaque thread développe son propre arbre à partir du même état,
+                    les statistiques des fils de leurs racines étant sommées avant de choisir le coup.
+    ARBRE_PARTAGE : tous les threads développent le même arbre (statistiques mises à jour de manière atomique,
+                    perte virtuelle pour répartir les threads sur des chemins différents).
+    FEUILLES      : un seul arbre est développé, les simulationsParFeuille simulations de chaque itération
+                    étant réparties entre les threads.
+    Dans les deux premiers modes, chaque thread réalise au plus iterationsmax itérations.
+    Lorsque les arbres comptent noeudsmax noeuds (répartis entre les arbres avec la parallélisation RACINE),
+    plus aucun noeud n'est développé : les itérations suivantes simulent à partir du noeud sélectionné
+    et affinent les statistiques de l'arbre existant (la mémoire des noeuds qui ne sont pas conservés
+    d'un coup à l'autre est récupérée lors de la reprise de l'arbre).
+    Le temps limite porte sur le temps réel écoulé (l'horloge n'est consultée qu'environ toutes les millisecondes).
+    La recherche s'arrête aussi dès que le drapeau annulation (s'il existe) est mis à une valeur non nulle par un autre thread ;
+    il peut alors remplacer le temps et le nombre d'itérations comme condition d'arrêt.
+    Hormis dans l'arbre partagé, les positions atteintes par plusieurs ordres de coups ne sont représentées
+    que par un seul noeud (table de transposition) : l'arbre est alors un graphe orienté acyclique.
+    Si le livre d'ouvertures est donné et contient la position, le coup est choisi directement
+    parmi les statistiques du livre avec la méthode methodeChoix (MAX se fonde alors sur la proportion de victoires),
+    sans recherche (les arbres conservés sont alors abandonnés lors du coup suivant).
+    Lorsqu'il ne reste pas plus de casesFinale cases vides, le coup est calculé par le solveur exact de fin de partie
+    (alpha-beta, voir finale.h) dans la moitié du temps maximal ou, sans limite de temps, en au plus
+    FINALE_NOEUDS_PAR_ITERATION positions par itération de la moitié de iterationsmax ;
+    si la résolution n'aboutit pas dans ce budget, la recherche MCTS est réalisée.
+    Si le fichier statistiques est donné, une ligne JSON par coup y est ajoutée (durée de chaque phase en cycles,
+    noeuds alloués, profondeurs maximale et moyenne, longueur moyenne des simulations, itérations par seconde...) ;
+    sinon la boucle de recherche ne relève aucune statistique.
+    Chaque thread tire ses coups aléatoires d'une suite indépendante issue du générateur alea
+    (avec un seul thread et sans limite de temps, la recherche est reproductible pour une graine donnée).
 
     *** Niveau d'optimisation de l'algorithme ***
                    0 : fonctionnement basique de l'algorithme MCTS avec UCB (UCT) (les simulations sont réalisées au hasard).
     (par défaut)   1 : (QUESTION 3 :) amélioration des simulations consistant à toujours choisir un coup gagnant lorsque cela est possible.
                    2 : lorsqu'un coup gagnant est possible, l'algorithme n'est pas utilisé et le coup est joué directement.
+                   3 : MCTS-Solver : les résultats des positions finales sont prouvés et remontés dans l'arbre
+                       (un noeud est gagnant si l'un de ses coups l'est, perdant ou nul si tous ses coups sont prouvés) ;
+                       la sélection écarte les sous-arbres résolus, aucune simulation n'est faite à partir d'un noeud prouvé,
+                       un coup prouvé gagnant est joué et la recherche s'arrête dès que la racine est prouvée.
+                   4 : comme 3, les simulations suivant la politique MENACES pour les deux joueurs
+                       (coup gagnant, sinon blocage du coup gagnant de l'adversaire, sinon coup au hasard).
 
     *** Niveau de verbosité du programme ***
                    0 : aucun affichage autre que la demande de coup et le plateau.
     (par défaut)   1 : (QUESTION 1:) affichage (à chaque coup de l’ordinateur) du coup joué, du nombre total de simulations réalisées (= nombre d'itérations) et d'une estimation de la probabilité de victoire pour l’ordinateur.
-                   2 : affichage (à chaque coup de l’ordinateur) du temps passé dans la boucle principale de l'algorithme MCTS et du nombre d'itérations réalisées.
+                   2 : affichage (à chaque coup de l’ordinateur) du temps passé dans la boucle principale de l'algorithme MCTS et du nombre d'itérations réalisées
+                       (ainsi que du nombre de noeuds, de ceux libérés à la reprise de l'arbre et des expansions refusées faute de mémoire).
                    3 : affichage (à chaque coup de l’ordinateur) du nombre de simulations réalisées pour chaque coup.
                    4 : affichage (à chaque coup de l’ordinateur) de la moyenne des récompenses pour chaque coup.
     */
-void ordijoue_mcts(Etat * etat, double tempsmax, int iterationsmax, MethodeChoixCoup methodeChoix, int optimisationLevel, int verboseLevel);
+void ordijoue_mcts(Etat * etat, ParametresMCTS * parametres);
+
+/** Calcule et joue un coup de l'ordinateur comme ordijoue_mcts, avec les arbres du moteur donné
+    (dont les statistiques cumulées sont mises à jour), et retourne le coup joué.
+    La réflexion du moteur éventuellement en cours est d'abord arrêtée. */
+Coup jouerCoupMCTS(MoteurMCTS * moteur, Etat * etat, ParametresMCTS * parametres);
+
+/** Lance en arrière-plan la réflexion du moteur sur l'état donné (où c'est à l'adversaire de jouer) :
+    un thread développe les arbres du moteur avec les mêmes paramètres que pour un coup
+    jusqu'à ce que la réflexion soit arrêtée (ou que le temps ou le nombre d'itérations d'un coup soit épuisé).
+    Lorsque le coup de l'adversaire arrive, jouerCoupMCTS arrête la réflexion et reprend le sous-arbre
+    correspondant : la recherche continue à partir de celui-ci dans le budget normal du coup.
+    (la réflexion utilise une suite de nombres aléatoires issue de alea, mais la recherche n'est plus reproductible)
+    Ne fait rien si l'état est final ou si le prochain coup du moteur sera calculé par le solveur exact. */
+void commencerReflexion(MoteurMCTS * moteur, Etat * etat, ParametresMCTS * parametres);
+
+/** Arrête la réflexion du moteur si elle est en cours (et attend la fin de son thread) */
+void arreterReflexion(MoteurMCTS * moteur);
+
+/** Lance la réflexion de l'ordinateur (qui joue avec ordijoue_mcts) pendant le tour de l'humain */
+void ordireflechit_mcts(Etat * etat, ParametresMCTS * parametres);
 
 #endif // MCTS_H_INCLUDED
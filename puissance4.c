@@ -2,19 +2,48 @@
 #include "utils.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
 
 // Macros
 #define ARRAY_LENGTH(x)  (sizeof(x) / sizeof((x)[0]))
 
+#define NB_PIONS(b) NB_BITS(b)
+
+// décalages correspondant aux directions : verticale, horizontale et les deux diagonales
+static const int directions[4] = { 1, HAUTEUR_COLONNE, HAUTEUR_COLONNE-1, HAUTEUR_COLONNE+1 };
+
+/** Retourne vrai si les pions forment un alignement de LONGUEUR_ALIGNEMENT pions */
+static bool alignement(Bitboard pions) {
+    int d;
+    for (d = 0 ; d < 4 ; d++)
+        if ( debutsAlignements(pions, directions[d]) )
+            return true;
+    return false;
+}
+
+/** Retourne vrai si le pion placé sur caseJouee forme un alignement de LONGUEUR_ALIGNEMENT pions avec les pions
+    (seules les 4 lignes passant par cette case sont examinées) */
+static bool alignementPassantPar(Bitboard pions, Bitboard caseJouee) {
+    int d;
+    for (d = 0 ; d < 4 ; d++) {
+        int n = 1;
+        Bitboard voisin;
+        // on compte les pions consécutifs de part et d'autre de la case jouée
+        for (voisin = caseJouee << directions[d] ; voisin & pions ; voisin <<= directions[d])
+            n++;
+        for (voisin = caseJouee >> directions[d] ; voisin & pions ; voisin >>= directions[d])
+            n++;
+        if ( n >= LONGUEUR_ALIGNEMENT )
+            return true;
+    }
+    return false;
+}
+
 Etat * copieEtat(Etat * src) {
 	Etat * etat = (Etat *)malloc(sizeof(Etat));
 
-	etat->joueur = src->joueur;
-
-    int i, j;
-	for (i=0; i < ARRAY_LENGTH(etat->plateau); i++)
-		for ( j=0; j < ARRAY_LENGTH(etat->plateau[0]); j++)
-			etat->plateau[i][j] = src->plateau[i][j];
+	*etat = *src;
 
 	return etat;
 }
@@ -22,30 +51,86 @@ Etat * copieEtat(Etat * src) {
 Etat * etat_initial(void) {
 	Etat * etat = (Etat *)malloc(sizeof(Etat));
 
-	int i, j;
-	for (i=0; i < ARRAY_LENGTH(etat->plateau); i++)
-		for ( j=0; j < ARRAY_LENGTH(etat->plateau[0]); j++)
-			etat->plateau[i][j] = ' ';
+	etat->joueur = 0;
+	etat->pions[0] = 0;
+	etat->pions[1] = 0;
+	etat->masque = 0;
+	etat->nb_coups = 0;
+	etat->fin = NON;
 
 	return etat;
 }
 
+void etatVersPlateau(Etat * etat, char plateau[NB_LIGNES][NB_COLONNES]) {
+
+	int i, j;
+	for (i=0; i < NB_LIGNES; i++) {
+		for ( j=0; j < NB_COLONNES; j++) {
+			Bitboard caseCourante = BIT(NB_LIGNES-1-i, j);   // la ligne 0 du plateau est la ligne du haut
+			if ( etat->pions[1] & caseCourante )
+				plateau[i][j] = 'O';
+			else if ( etat->pions[0] & caseCourante )
+				plateau[i][j] = 'X';
+			else
+				plateau[i][j] = ' ';
+		}
+	}
+}
+
+void plateauVersEtat(char plateau[NB_LIGNES][NB_COLONNES], int joueur, Etat * etat) {
+
+	etat->joueur = joueur;
+	etat->pions[0] = 0;
+	etat->pions[1] = 0;
+
+	int i, j;
+	for (i=0; i < NB_LIGNES; i++) {
+		for ( j=0; j < NB_COLONNES; j++) {
+			Bitboard caseCourante = BIT(NB_LIGNES-1-i, j);
+			if ( plateau[i][j] == 'O' )
+				etat->pions[1] |= caseCourante;
+			else if ( plateau[i][j] == 'X' )
+				etat->pions[0] |= caseCourante;
+		}
+	}
+	etat->masque = etat->pions[0] | etat->pions[1];
+	etat->nb_coups = NB_PIONS(etat->masque);
+
+	// le plateau ne provient pas de jouerCoup : la fin de partie est testée sur tout le plateau
+	if ( alignement(etat->pions[1]) )
+		etat->fin = ORDI_GAGNE;
+	else if ( alignement(etat->pions[0]) )
+		etat->fin = HUMAIN_GAGNE;
+	else if ( etat->nb_coups == NB_LIGNES * NB_COLONNES )
+		etat->fin = MATCHNUL;
+	else
+		etat->fin = NON;
+}
+
 void afficheJeu(Etat * etat) {
 
+	char plateau[NB_LIGNES][NB_COLONNES];
+	etatVersPlateau(etat, plateau);
+
+	// ligne de séparation : 4 caractères par colonne et pour les numéros de lignes
+	char separation[4 * (NB_COLONNES + 1) + 1];
+	memset(separation, '-', sizeof(separation) - 1);
+	separation[sizeof(separation) - 1] = '\0';
+
 	int i, j;
 	printf("   |");
-	for ( j = 0; j < ARRAY_LENGTH(etat->plateau[0]); j++)
+	for ( j = 0; j < ARRAY_LENGTH(plateau[0]); j++)
 		printf(" %d |", j);
 	printf("\n");
-	printf("--------------------------------");
+	printf("%s", separation);
 	printf("\n");
 
-	for(i=0; i < ARRAY_LENGTH(etat->plateau); i++) {
+	for(i=0; i < ARRAY_LENGTH(plateau); i++) {
 		printf(" %d |", i);
-		for ( j = 0; j < ARRAY_LENGTH(etat->plateau[0]); j++)
-			printf(" %c |", etat->plateau[i][j]);
+		for ( j = 0; j < ARRAY_LENGTH(plateau[0]); j++)
+			printf(" %c |", plateau[i][j]);
 		printf("\n");
-		printf("--------------------------------");
+		printf("%s", separation);
 		printf("\n");
 	}
 }
@@ -71,26 +156,26 @@ Coup * demanderCoup(void) {
 int jouerCoup(Etat * etat, Coup * coup) {
 
     // le coup est impossible si il est en dehors des limites
-    // ou si la colonne est rempli (donc premiére ligne occupée)
-	if ( coup->colonne < 0 || coup->colonne >= ARRAY_LENGTH(etat->plateau[0]) ||
-     etat->plateau[0][coup->colonne] != ' ')
+    // ou si la colonne est rempli (donc case du haut occupée)
+	if ( coup->colonne < 0 || coup->colonne >= NB_COLONNES ||
+     (etat->masque & MASQUE_HAUT_COLONNE(coup->colonne)) )
 		return 0;
 
-    // on cherche la ligne sur laquelle le pion doit être placée
-    int ligneJouee = -1;
-    int row = ARRAY_LENGTH(etat->plateau) - 1; // on part d'en bas du plateau (derniére ligne donc)
-    while (row >=0 && ligneJouee == -1) {
-        if (etat->plateau[row][coup->colonne] == ' ') // si l'emplacement est libre
-            ligneJouee = row;
-        else
-            row--;
-    }
+    // la case jouée est la première case libre de la colonne :
+    // ajouter le bas de la colonne aux cases occupées fait "monter" la retenue jusqu'à elle
+    Bitboard caseJouee = (etat->masque + MASQUE_BAS_COLONNE(coup->colonne)) & MASQUE_COLONNE(coup->colonne);
 
-    // cas d'erreur impossible en temps normal
-    if (ligneJouee == -1)
-        return 0;
+    etat->pions[etat->joueur] |= caseJouee;
+    etat->masque |= caseJouee;
+    etat->nb_coups++;
 
-    etat->plateau[ligneJouee][coup->colonne] = etat->joueur ? 'O' : 'X';
+    // seul le pion joué peut avoir créé un alignement
+    if (etat->fin == NON) {
+        if ( alignementPassantPar(etat->pions[etat->joueur], caseJouee) )
+            etat->fin = etat->joueur == 1 ? ORDI_GAGNE : HUMAIN_GAGNE;
+        else if ( etat->nb_coups == NB_LIGNES * NB_COLONNES )
+            etat->fin = MATCHNUL;
+    }
 
     // à l'autre joueur de jouer
     etat->joueur = AUTRE_JOUEUR(etat->joueur);
@@ -106,9 +191,9 @@ Coup ** coups_possibles(Etat * etat) {
 
 	int column;
 	// on parcourt les colonnes
-	for(column=0; column < ARRAY_LENGTH(etat->plateau[0]); column++) {
-        // on vérifie que la colonne courante n'est pas remplie (donc première ligne non occupée)
-        if ( etat->plateau[0][column] == ' ' ) {
+	for(column=0; column < NB_COLONNES; column++) {
+        // on vérifie que la colonne courante n'est pas remplie (donc case du haut non occupée)
+        if ( !(etat->masque & MASQUE_HAUT_COLONNE(column)) ) {
             coups[k] = nouveauCoup(column);
             k++;
         }
@@ -119,63 +204,48 @@ Coup ** coups_possibles(Etat * etat) {
 	return coups;
 }
 
-int nombre_coups_possibles(Etat * etat) {
-    int count = 0;
+unsigned int masque_coups_possibles(Etat * etat) {
+    unsigned int coups = 0;
 	int column;
 	// on parcourt les colonnes
-	for(column=0; column < ARRAY_LENGTH(etat->plateau[0]); column++)
-        // on vérifie que la colonne courante n'est pas remplie (donc premiére ligne non occupée)
-        if ( etat->plateau[0][column] == ' ' )
-            count++;
+	for(column=0; column < NB_COLONNES; column++)
+        // on vérifie que la colonne courante n'est pas remplie (donc case du haut non occupée)
+        if ( !(etat->masque & MASQUE_HAUT_COLONNE(column)) )
+            coups |= 1u << column;
 
-    return count;
+    return coups;
 }
 
-FinDePartie testFin(Etat * etat) {
+int nombre_coups_possibles(Etat * etat) {
+    // une colonne est jouable si sa case du haut est libre
+    return NB_COLONNES - NB_PIONS(etat->masque & MASQUE_HAUT);
+}
 
-    int largeurPlateau = ARRAY_LENGTH(etat->plateau);
-    int hauteurPlateau = ARRAY_LENGTH(etat->plateau[0]);
-
-	// tester si un joueur a gagné
-	int i, j, k, n = 0;
-	for (i=0; i < largeurPlateau; i++) {
-		for(j=0; j < hauteurPlateau; j++) {
-			if ( etat->plateau[i][j] != ' ') {
-				n++;	// nb coups joués
-
-				// lignes
-				k=0;
-				while ( k < 4 && i+k < largeurPlateau && etat->plateau[i+k][j] == etat->plateau[i][j] )
-					k++;
-				if ( k == 4 )
-					return etat->plateau[i][j] == 'O'? ORDI_GAGNE : HUMAIN_GAGNE;
-
-				// colonnes
-				k=0;
-				while ( k < 4 && j+k < hauteurPlateau && etat->plateau[i][j+k] == etat->plateau[i][j] )
-					k++;
-				if ( k == 4 )
-					return etat->plateau[i][j] == 'O'? ORDI_GAGNE : HUMAIN_GAGNE;
-
-				// diagonales
-				k=0;
-				while ( k < 4 && i+k < largeurPlateau && j+k < hauteurPlateau && etat->plateau[i+k][j+k] == etat->plateau[i][j] )
-					k++;
-				if ( k == 4 )
-					return etat->plateau[i][j] == 'O'? ORDI_GAGNE : HUMAIN_GAGNE;
-
-				k=0;
-				while ( k < 4 && i+k < largeurPlateau && j-k >= 0 && etat->plateau[i+k][j-k] == etat->plateau[i][j] )
-					k++;
-				if ( k == 4 )
-					return etat->plateau[i][j] == 'O'? ORDI_GAGNE : HUMAIN_GAGNE;
-			}
-		}
-	}
+uint64_t clePosition(Etat * etat) {
+    // dans chaque colonne, ajouter le bas de la colonne aux cases occupées donne un bit au dessus du dernier pion :
+    // la hauteur est ainsi codée sans ambiguïté et les bits situés en dessous sont ceux des pions de l'ordinateur
+    // (le bit 63, inutilisé par le plateau, code le joueur qui doit jouer)
+    Bitboard cle = etat->pions[1] + etat->masque + MASQUE_BAS;
+#if NB_COLONNES * HAUTEUR_COLONNE < 64
+    return (uint64_t)cle ^ ((uint64_t)etat->joueur << 63);
+#else
+    // plateau de plus de 63 bits : la clé est hachée sur 64 bits
+    return hacherBitboard(cle) ^ ((uint64_t)etat->joueur << 63);
+#endif
+}
 
-	// et sinon tester le match nul
-	if ( n == ARRAY_LENGTH(etat->plateau) * ARRAY_LENGTH(etat->plateau[0]) )
-		return MATCHNUL;
+void inverserJoueurs(Etat * etat) {
+    Bitboard pions = etat->pions[0];
+    etat->pions[0] = etat->pions[1];
+    etat->pions[1] = pions;
+    etat->joueur = AUTRE_JOUEUR(etat->joueur);
+
+    if (etat->fin == ORDI_GAGNE)
+        etat->fin = HUMAIN_GAGNE;
+    else if (etat->fin == HUMAIN_GAGNE)
+        etat->fin = ORDI_GAGNE;
+}
 
-	return NON;
+FinDePartie testFin(Etat * etat) {
+	return etat->fin;
 }
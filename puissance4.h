@@ -1,12 +1,32 @@
 #ifndef PUISSANCE4_H_INCLUDED
 #define PUISSANCE4_H_INCLUDED
 
+#include <stdint.h>
+
 /**
     Fonctions propres au fonctionnement du jeu.
 */
 
-// Paramètres du jeu
-#define LARGEUR_MAX 7 		// nb max de fils pour un noeud (= nb max de coups possibles)
+// Paramètres du jeu (modifiables à la compilation, par exemple -DNB_LIGNES=7 -DNB_COLONNES=8 -DLONGUEUR_ALIGNEMENT=5)
+#ifndef NB_LIGNES
+#define NB_LIGNES 6 		// nb de lignes du plateau
+#endif
+#ifndef NB_COLONNES
+#define NB_COLONNES 7 		// nb de colonnes du plateau
+#endif
+#ifndef LONGUEUR_ALIGNEMENT
+#define LONGUEUR_ALIGNEMENT 4 		// nb de pions à aligner pour gagner
+#endif
+#define LARGEUR_MAX NB_COLONNES 		// nb max de fils pour un noeud (= nb max de coups possibles)
+#define NB_CASES (NB_LIGNES*NB_COLONNES)  // nb de cases du plateau
+
+// (les coups possibles sont représentés par un masque de colonnes de 16 bits dans les noeuds de l'arbre)
+#if NB_COLONNES > 16
+#error "Le plateau ne peut pas avoir plus de 16 colonnes."
+#endif
+#if LONGUEUR_ALIGNEMENT < 2
+#error "Il faut aligner au moins 2 pions."
+#endif
 
 // Macros
 #define AUTRE_JOUEUR(i) (1-(i))
@@ -14,13 +34,131 @@
 /** Critères de fin de partie */
 typedef enum { NON, MATCHNUL, ORDI_GAGNE, HUMAIN_GAGNE } FinDePartie;
 
+/** Plateau (ou partie de plateau) représenté par un ensemble de bits.
+    Les cases sont rangées colonne par colonne, de bas en haut :
+    la case (ligne l en partant du bas, colonne c) correspond au bit c*(NB_LIGNES+1) + l.
+    Chaque colonne possède un bit supplémentaire (toujours nul) au dessus de sa dernière ligne
+    afin que les alignements ne puissent pas "déborder" d'une colonne à l'autre.
+    Le type est choisi à la compilation selon la taille du plateau : entier de 64 bits
+    (Puissance 4 et plateaux jusqu'à 64 bits), sinon entier de 128 bits. */
+#if NB_COLONNES * (NB_LIGNES+1) <= 64
+typedef uint64_t Bitboard;
+#define BITS_BITBOARD 64
+#elif NB_COLONNES * (NB_LIGNES+1) <= 128
+typedef unsigned __int128 Bitboard;
+#define BITS_BITBOARD 128
+#else
+#error "Le plateau ne tient pas sur 128 bits (NB_COLONNES * (NB_LIGNES+1) doit être au plus 128)."
+#endif
+
+// Bitboards
+#define HAUTEUR_COLONNE (NB_LIGNES+1)   // nb de bits par colonne (avec la ligne sentinelle)
+#define BIT(ligne, colonne) ((Bitboard)1 << ((colonne)*HAUTEUR_COLONNE + (ligne)))  // ligne 0 = ligne du bas
+#define MASQUE_BAS_COLONNE(c) BIT(0, c)
+#define MASQUE_HAUT_COLONNE(c) BIT(NB_LIGNES-1, c)
+#define MASQUE_COLONNE(c) ((((Bitboard)1 << NB_LIGNES) - 1) << ((c)*HAUTEUR_COLONNE))
+// case la plus basse de chaque colonne (tous les bits des colonnes divisés par les bits d'une colonne)
+#define MASQUE_BAS ((~(Bitboard)0 >> (BITS_BITBOARD - NB_COLONNES*HAUTEUR_COLONNE)) / (((Bitboard)1 << HAUTEUR_COLONNE) - 1))
+// case la plus haute de chaque colonne
+#define MASQUE_HAUT (MASQUE_BAS << (NB_LIGNES-1))
+// toutes les cases du plateau
+#define MASQUE_PLATEAU (MASQUE_BAS * (((Bitboard)1 << NB_LIGNES) - 1))
+
+// (les alignements sont cherchés en décalant les bitboards d'au plus LONGUEUR_ALIGNEMENT-1 cases en diagonale)
+#if (LONGUEUR_ALIGNEMENT-1) * (HAUTEUR_COLONNE+1) >= BITS_BITBOARD
+#error "Alignement trop long pour le plateau."
+#endif
+
+// Nb de bits à 1 et indice du bit à 1 le plus faible (non nul) d'un bitboard
+#if BITS_BITBOARD == 64
+#define NB_BITS(b) __builtin_popcountll(b)
+#define PREMIER_BIT(b) __builtin_ctzll(b)
+#else
+#define NB_BITS(b) (__builtin_popcountll((uint64_t)(b)) + __builtin_popcountll((uint64_t)((b) >> 64)))
+#define PREMIER_BIT(b) ((uint64_t)(b) != 0 ? __builtin_ctzll((uint64_t)(b)) : 64 + __builtin_ctzll((uint64_t)((b) >> 64)))
+#endif
+
+/** Retourne les cases ayant, dans la direction de décalage s, i pions alignés avant elles
+    et LONGUEUR_ALIGNEMENT-1-i après (pour un i quelconque).
+    Les alignements i et i+1 sont testés ensemble : ils partagent i pions avant la case
+    et LONGUEUR_ALIGNEMENT-2-i après, et diffèrent par un seul pion à chacune de leurs extrémités. */
+static inline __attribute__((always_inline)) Bitboard casesGagnantesDirection(Bitboard pions, int s) {
+	Bitboard r = 0;
+	int i, j, m;
+	for (i = 0 ; i < LONGUEUR_ALIGNEMENT ; i += 2) {
+		j = i < LONGUEUR_ALIGNEMENT - 1 ? i : LONGUEUR_ALIGNEMENT - 2;    // (le dernier couple peut chevaucher le précédent)
+		// pion à l'extrémité propre à chacun des deux alignements, puis pions qu'ils ont en commun
+		Bitboard couple = (pions << ((j + 1) * s)) | (pions >> ((LONGUEUR_ALIGNEMENT - 1 - j) * s));
+		for (m = 1 ; m <= j ; m++)
+			couple &= pions << (m * s);
+		for (m = 1 ; m < LONGUEUR_ALIGNEMENT - 1 - j ; m++)
+			couple &= pions >> (m * s);
+		r |= couple;
+	}
+	return r;
+}
+
+/** Retourne les cases vides qui compléteraient un alignement avec les pions (menaces des pions)
+    (la longueur de l'alignement et les décalages étant des constantes, tout est déroulé à la compilation) */
+static inline Bitboard casesGagnantes(Bitboard pions, Bitboard masque) {
+	int i;
+
+	// verticale : LONGUEUR_ALIGNEMENT-1 pions en dessous de la case
+	Bitboard r = pions << 1;
+	for (i = 2 ; i < LONGUEUR_ALIGNEMENT ; i++)
+		r &= pions << i;
+
+	// horizontale et diagonales
+	r |= casesGagnantesDirection(pions, HAUTEUR_COLONNE);
+	r |= casesGagnantesDirection(pions, HAUTEUR_COLONNE - 1);
+	r |= casesGagnantesDirection(pions, HAUTEUR_COLONNE + 1);
+
+	return r & (MASQUE_PLATEAU ^ masque);
+}
+
+/** Retourne les cases où commence (dans le sens des bits croissants) un alignement des pions dans la direction
+    de décalage s : la longueur des suites de pions consécutifs double à chaque étape */
+static inline Bitboard debutsAlignements(Bitboard pions, int s) {
+	Bitboard suites = pions;
+	int longueur = 1;
+	while (2 * longueur <= LONGUEUR_ALIGNEMENT) {
+		suites &= suites >> (longueur * s);
+		longueur *= 2;
+	}
+	if (longueur < LONGUEUR_ALIGNEMENT)
+		suites &= suites >> ((LONGUEUR_ALIGNEMENT - longueur) * s);
+	return suites;
+}
+
+/** Réduit un bitboard à une valeur de 64 bits bien mélangée
+    (hachage : deux bitboards différents peuvent, très rarement, donner la même valeur) */
+static inline uint64_t hacherBitboard(Bitboard b) {
+	uint64_t h = (uint64_t)b;
+#if BITS_BITBOARD == 128
+	h ^= (uint64_t)(b >> 64) * 0x9E3779B97F4A7C15ULL;
+#endif
+	h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+	return h ^ (h >> 31);
+}
+
+/** Retourne les cases jouables (la case la plus basse de chaque colonne non pleine) */
+static inline Bitboard casesJouables(Bitboard masque) {
+	return (masque + MASQUE_BAS) & MASQUE_PLATEAU;
+}
+
 /** Définition du type Etat (état/position du jeu) */
 typedef struct EtatSt {
 
 	int joueur; // à qui de jouer ?
 
-	// 6 lignes et 7 colonnes au Puissance 4
-	char plateau[6][7];
+	// NB_LIGNES lignes et NB_COLONNES colonnes (6 et 7 au Puissance 4), stockées sous forme de bitboards
+	Bitboard pions[2];  // pions de chaque joueur (0 : humain 'X', 1 : ordinateur 'O')
+	Bitboard masque;    // cases occupées par l'un ou l'autre des joueurs (donne la hauteur de chaque colonne)
+
+	// tenus à jour par jouerCoup à chaque coup joué
+	int nb_coups;       // nb de coups joués depuis le début de la partie
+	FinDePartie fin;    // état de fin de partie
 
 } Etat;
 
@@ -38,6 +176,14 @@ Etat * copieEtat(Etat * src);
 /** Etat initial */
 Etat * etat_initial(void);
 
+/** Convertit l'état en plateau de caractères ('X', 'O' ou ' ')
+    la ligne 0 étant la ligne du haut */
+void etatVersPlateau(Etat * etat, char plateau[NB_LIGNES][NB_COLONNES]);
+
+/** Construit l'état correspondant à un plateau de caractères ('X', 'O' ou ' ')
+    et au joueur qui doit jouer */
+void plateauVersEtat(char plateau[NB_LIGNES][NB_COLONNES], int joueur, Etat * etat);
+
 /** Affiche le plateau de jeu */
 void afficheJeu(Etat * etat);
 
@@ -49,6 +195,7 @@ Coup * nouveauCoup(int col);
 Coup * demanderCoup(void);
 
 /** Modifier l'état en jouant un coup
+    (et mettre à jour la fin de partie en ne testant que les alignements passant par le pion joué)
     retourne 0 si le coup n'est pas possible */
 int jouerCoup(Etat * etat, Coup * coup);
 
@@ -56,11 +203,25 @@ int jouerCoup(Etat * etat, Coup * coup);
     (tableau de pointeurs de coups se terminant par NULL) */
 Coup ** coups_possibles(Etat * etat);
 
+/** Retourne l'ensemble des coups possibles sous forme de masque de colonnes
+    (le bit c est à 1 si la colonne c peut être jouée) */
+unsigned int masque_coups_possibles(Etat * etat);
+
 /** Compte le nombre de coups possibles */
 int nombre_coups_possibles(Etat * etat);
 
+/** Retourne une clé identifiant la position
+    (deux états ont la même clé si et seulement si leurs pions et le joueur qui doit jouer sont les mêmes ;
+    si le plateau occupe plus de 63 bits, la clé est hachée et deux positions peuvent très rarement la partager) */
+uint64_t clePosition(Etat * etat);
+
+/** Echange les rôles des deux joueurs (pions, joueur qui doit jouer et résultat) :
+    permet à l'algorithme, qui joue toujours pour l'ordinateur, de jouer pour l'humain */
+void inverserJoueurs(Etat * etat);
+
 /** Test si l'état est un état terminal
-    et retourne NON, MATCHNUL, ORDI_GAGNE ou HUMAIN_GAGNE */
+    et retourne NON, MATCHNUL, ORDI_GAGNE ou HUMAIN_GAGNE
+    (simple lecture du résultat tenu à jour par jouerCoup) */
 FinDePartie testFin( Etat * etat );
 
 #endif // PUISSANCE4_H_INCLUDED
@@ -0,0 +1,98 @@
+#include "transposition.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+// Paramètres de la table
+#define TABLE_BITS_INITIAL 16   // log2 de la capacité initiale
+
+/** Retourne la case de départ de la recherche d'une clé (hachage multiplicatif) */
+static uint32_t caseDepart(TableTransposition * table, uint64_t cle) {
+	return (uint32_t)((cle * 0x9E3779B97F4A7C15ULL) >> (64 - table->bits));
+}
+
+/** Alloue les entrées de la table pour la capacité donnée (toutes invalides) */
+static void allouerEntrees(TableTransposition * table, int bits) {
+	table->bits = bits;
+	table->entrees = (EntreeTransposition *)calloc((size_t)1 << bits, sizeof(EntreeTransposition));
+	if (table->entrees == NULL) {
+		fprintf(stderr, "Mémoire insuffisante pour allouer la table de transposition.\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+TableTransposition * nouvelleTable(void) {
+	TableTransposition * table = (TableTransposition *)malloc(sizeof(TableTransposition));
+
+	allouerEntrees(table, TABLE_BITS_INITIAL);
+	table->nb_entrees = 0;
+	table->generation = 1;  // les entrées allouées (génération 0) sont invalides
+
+	return table;
+}
+
+uint32_t chercherPosition(TableTransposition * table, uint64_t cle) {
+	uint32_t masque = ((uint32_t)1 << table->bits) - 1;
+	uint32_t i = caseDepart(table, cle);
+
+	// on parcourt les cases à partir de la case de départ jusqu'à une case libre
+	while (table->entrees[i].generation == table->generation) {
+		if (table->entrees[i].cle == cle)
+			return table->entrees[i].indice;
+		i = (i + 1) & masque;
+	}
+	return TABLE_AUCUN;
+}
+
+/** Place une entrée dans la première case libre à partir de sa case de départ */
+static void placerEntree(TableTransposition * table, uint64_t cle, uint32_t indice) {
+	uint32_t masque = ((uint32_t)1 << table->bits) - 1;
+	uint32_t i = caseDepart(table, cle);
+
+	while (table->entrees[i].generation == table->generation)
+		i = (i + 1) & masque;
+
+	table->entrees[i].cle = cle;
+	table->entrees[i].indice = indice;
+	table->entrees[i].generation = table->generation;
+}
+
+void ajouterPosition(TableTransposition * table, uint64_t cle, uint32_t indice) {
+
+	// Si la table est à moitié pleine, on double sa capacité
+	if (2 * (table->nb_entrees + 1) > ((uint32_t)1 << table->bits)) {
+		EntreeTransposition * anciennes = table->entrees;
+		uint32_t ancienneCapacite = (uint32_t)1 << table->bits;
+		uint32_t ancienneGeneration = table->generation;
+
+		allouerEntrees(table, table->bits + 1);
+		table->generation = 1;
+
+		uint32_t i;
+		for (i = 0 ; i < ancienneCapacite ; i++)
+			if (anciennes[i].generation == ancienneGeneration)
+				placerEntree(table, anciennes[i].cle, anciennes[i].indice);
+		free(anciennes);
+	}
+
+	placerEntree(table, cle, indice);
+	table->nb_entrees++;
+}
+
+void viderTable(TableTransposition * table) {
+	table->nb_entrees = 0;
+	table->generation++;
+
+	// Après avoir épuisé les générations, les entrées sont réellement effacées
+	if (table->generation == 0) {
+		size_t i;
+		for (i = 0 ; i < ((size_t)1 << table->bits) ; i++)
+			table->entrees[i].generation = 0;
+		table->generation = 1;
+	}
+}
+
+void freeTable(TableTransposition * table) {
+	free(table->entrees);
+	free(table);
+}
@@ -0,0 +1,50 @@
+#ifndef TRANSPOSITION_H_INCLUDED
+#define TRANSPOSITION_H_INCLUDED
+
+#include <stdint.h>
+
+/**
+    Table de transposition : associe à la clé d'une position l'indice (dans une arène)
+    du noeud qui la représente, afin qu'une position atteinte par différents ordres de coups
+    ne soit représentée qu'une seule fois.
+    Table à adressage ouvert, agrandie automatiquement et vidée en temps constant.
+*/
+
+/** Indice d'une position absente de la table */
+#define TABLE_AUCUN UINT32_MAX
+
+/** Entrée de la table */
+typedef struct {
+
+	uint64_t cle;           // clé de la position
+	uint32_t indice;        // indice du noeud correspondant
+	uint32_t generation;    // l'entrée n'est valide que si elle est de la génération courante de la table
+
+} EntreeTransposition;
+
+/** Définition du type TableTransposition */
+typedef struct {
+
+	EntreeTransposition * entrees;
+	int bits;               // log2 de la capacité
+	uint32_t nb_entrees;    // nb d'entrées valides
+	uint32_t generation;    // génération courante (incrémentée à chaque vidage)
+
+} TableTransposition;
+
+/** Créer une nouvelle table (vide) */
+TableTransposition * nouvelleTable(void);
+
+/** Retourne l'indice associé à la clé (TABLE_AUCUN si la clé est absente) */
+uint32_t chercherPosition(TableTransposition * table, uint64_t cle);
+
+/** Associe l'indice à la clé (la clé ne doit pas être déjà présente) */
+void ajouterPosition(TableTransposition * table, uint64_t cle, uint32_t indice);
+
+/** Vide la table en temps constant (la mémoire est conservée) */
+void viderTable(TableTransposition * table);
+
+/** Libère la mémoire de la table */
+void freeTable(TableTransposition * table);
+
+#endif // TRANSPOSITION_H_INCLUDED
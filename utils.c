@@ -22,6 +22,18 @@ bool convertStringToInt(char * string, int * result) {
     return false;
 }
 
+bool convertStringToUInt64(char * string, uint64_t * result) {
+    char * end = NULL;
+    errno = 0;
+    unsigned long long temp = strtoull(string, &end, 10);
+
+    if (*string != '\0' && *string != '-' && *end == '\0' && errno != ERANGE && temp <= UINT64_MAX) {
+        *result = (uint64_t)temp;
+        return true;
+    }
+    return false;
+}
+
 bool convertStringToDouble(char * string, double * result) {
     char * end = NULL;
     errno = 0;
@@ -2,6 +2,7 @@
 #define UTILS_H_INCLUDED
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /**
     Fonctions utilitaires.
@@ -14,6 +15,10 @@ int clean_stdin(void);
     Retourne true si la conversion s'est déroulée correctement, false sinon. */
 bool convertStringToInt(char * string, int * result);
 
+/** Convertit un string (char*) en entier non signé sur 64 bits et stocke le résultat dans result.
+    Retourne true si la conversion s'est déroulée correctement, false sinon. */
+bool convertStringToUInt64(char * string, uint64_t * result);
+
 /** Convertit un string (char*) en double et stocke le résultat dans result.
     Retourne true si la conversion s'est déroulée correctement, false sinon. */
 bool convertStringToDouble(char * string, double * result);